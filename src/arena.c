@@ -0,0 +1,136 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "logging.h"
+#include "arena.h"
+
+#define ARENA_BLOCK_SIZE 0x40000U // Blocks are at least this size, larger if needed for an allocation
+#define ARENA_ALIGN      16U
+
+#define ARENA_ALIGN_UP(size) (((size) + (ARENA_ALIGN - 1)) & ~((size_t)ARENA_ALIGN - 1))
+#define ARENA_BLOCK_DATA(p_block) ((uint_least8_t *)(p_block) + ARENA_ALIGN_UP(sizeof(arena_block)))
+
+
+void arena_init(arena_type * p_arena) {
+
+    p_arena->p_head = NULL;
+    p_arena->p_last = NULL;
+}
+
+
+// Free all blocks, any pointers from the arena are invalid afterward
+void arena_release(arena_type * p_arena) {
+
+    while (p_arena->p_head) {
+        arena_block * p_prev = p_arena->p_head->p_prev;
+        free(p_arena->p_head);
+        p_arena->p_head = p_prev;
+    }
+    p_arena->p_last = NULL;
+}
+
+
+// Returns true if there is room for size more bytes in the current block
+static bool arena_fits(const arena_type * p_arena, size_t size) {
+
+    return ((p_arena->p_head) && ((p_arena->p_head->size - p_arena->p_head->used) >= size));
+}
+
+
+static void arena_add_block(arena_type * p_arena, size_t size) {
+
+    if (size < ARENA_BLOCK_SIZE) size = ARENA_BLOCK_SIZE;
+
+    arena_block * p_block = (arena_block *)malloc(ARENA_ALIGN_UP(sizeof(arena_block)) + size);
+    if (!p_block) {
+        log_error("Error: Failed to allocate memory for arena!\n");
+        exit(EXIT_FAILURE);
+    }
+    p_block->p_prev = p_arena->p_head;
+    p_block->used   = 0;
+    p_block->size   = size;
+    p_arena->p_head = p_block;
+}
+
+
+// Returns uninitialized memory, never NULL (exits on failure)
+void * arena_alloc(arena_type * p_arena, size_t size) {
+
+    size = ARENA_ALIGN_UP(size);
+
+    if (!arena_fits(p_arena, size))
+        arena_add_block(p_arena, size);
+
+    p_arena->p_last = ARENA_BLOCK_DATA(p_arena->p_head) + p_arena->p_head->used;
+    p_arena->p_head->used += size;
+
+    return p_arena->p_last;
+}
+
+
+// Returns zeroed memory, never NULL (exits on failure)
+void * arena_calloc(arena_type * p_arena, size_t size) {
+
+    void * p_new = arena_alloc(p_arena, size);
+    memset(p_new, 0, size);
+    return p_new;
+}
+
+
+// Grow an allocation, old contents are preserved
+//
+// The most recent allocation gets extended in place when there is room,
+// otherwise it's copied to a new allocation. The old space isn't reused
+// until the arena is released or rewound.
+void * arena_realloc(arena_type * p_arena, void * p_old, size_t old_size, size_t new_size) {
+
+    if (!p_old)
+        return arena_alloc(p_arena, new_size);
+
+    if (new_size <= old_size)
+        return p_old;
+
+    if (p_old == p_arena->p_last) {
+        size_t grow = ARENA_ALIGN_UP(new_size) - ARENA_ALIGN_UP(old_size);
+        if (arena_fits(p_arena, grow)) {
+            p_arena->p_head->used += grow;
+            return p_old;
+        }
+    }
+
+    void * p_new = arena_alloc(p_arena, new_size);
+    memcpy(p_new, p_old, old_size);
+    return p_new;
+}
+
+
+// Save the current position, arena_rewind() frees everything allocated after it
+arena_mark arena_get_mark(const arena_type * p_arena) {
+
+    arena_mark mark;
+
+    mark.p_block = p_arena->p_head;
+    mark.used    = (p_arena->p_head) ? p_arena->p_head->used : 0;
+    return mark;
+}
+
+
+// Free everything allocated since the mark was taken
+void arena_rewind(arena_type * p_arena, arena_mark mark) {
+
+    while (p_arena->p_head != mark.p_block) {
+        arena_block * p_prev = p_arena->p_head->p_prev;
+        free(p_arena->p_head);
+        p_arena->p_head = p_prev;
+    }
+    if (p_arena->p_head)
+        p_arena->p_head->used = mark.used;
+    p_arena->p_last = NULL;
+}
@@ -0,0 +1,37 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#ifndef _ARENA_H
+#define _ARENA_H
+
+// Bump allocator: memory is handed out from large blocks and only
+// given back all at once with arena_release() (or back to a mark
+// with arena_rewind() for short lived buffers).
+
+typedef struct arena_block {
+    struct arena_block * p_prev;
+    size_t               used;
+    size_t               size;
+    // Data follows (after padding to ARENA_ALIGN)
+} arena_block;
+
+typedef struct arena_type {
+    arena_block * p_head; // Most recent block
+    void *        p_last; // Most recent allocation, can be grown in place
+} arena_type;
+
+typedef struct arena_mark {
+    arena_block * p_block;
+    size_t        used;
+} arena_mark;
+
+void arena_init(arena_type * p_arena);
+void arena_release(arena_type * p_arena);
+void * arena_alloc(arena_type * p_arena, size_t size);
+void * arena_calloc(arena_type * p_arena, size_t size);
+void * arena_realloc(arena_type * p_arena, void * p_old, size_t old_size, size_t new_size);
+arena_mark arena_get_mark(const arena_type * p_arena);
+void arena_rewind(arena_type * p_arena, arena_mark mark);
+
+#endif // _ARENA_H
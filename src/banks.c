@@ -11,33 +11,142 @@
 #include "common.h"
 #include "logging.h"
 #include "list.h"
+#include "arena.h"
 #include "banks.h"
 #include "bank_templates.h"
 #include "banks_print.h"
 #include "banks_summarized.h"
+#include "str_intern.h"
 
 
 static int area_item_compare(const void* a, const void* b);
+static void areas_sort(area_item * areas, uint32_t count);
+static void bank_area_order_build(bank_item * p_bank);
 static int bank_item_compare(const void* a, const void* b);
 static bool banks_check_larger_than_32k(void);
 static void areas_check_rom0_overflow(void);
 
+
+// Bit counting helpers, compiler builtins where available
+
+// Number of set bits
+static inline uint32_t bits_count_u64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_popcountll(value);
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (uint32_t)((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+
+// Index of the lowest set bit, value must not be zero
+static inline int bits_lowest_u32(uint32_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(value);
+#else
+    int idx = 0;
+    while (!(value & 1U)) {
+        value >>= 1;
+        idx++;
+    }
+    return idx;
+#endif
+}
+
 // Not ready for use until a call to banks_init_templates()
 bank_item bank_templates[BANK_TEMPLATES_MAX];
 int       bank_templates_count;
 
+// Page table of which bank templates overlap each 256 byte page of the
+// unbanked address space, one bit per template index (so BANK_TEMPLATES_MAX
+// must be <= 32). Used to narrow down the templates an area gets checked against.
+#define TEMPLATE_PAGE_SHIFT  8
+#define TEMPLATE_PAGE_COUNT  ((MAX_ADDR_UNBANKED >> TEMPLATE_PAGE_SHIFT) + 1)
+#define TEMPLATE_PAGE(addr)  ((addr) >> TEMPLATE_PAGE_SHIFT)
+
+static uint32_t template_page_masks[TEMPLATE_PAGE_COUNT];
+static uint32_t template_mask_all;
+static uint32_t template_mask_sms_gg_LIT;  // Templates named "LIT_"
+static uint32_t template_mask_sms_gg_DATA; // Templates named "DATA_"
+
+// Registry for finding banks in bank_list by template start address and bank number.
+// Templates which share a start address (such as SMS/GG LIT_ and DATA_) share
+// a group, and each group has a dense array of bank_list indexes by bank number.
+// Only valid until bank_list gets sorted in banklist_finalize_and_show().
+#define BANK_REGISTRY_EMPTY  -1
+#define BANK_REGISTRY_GROW   64
+
+static int       template_bank_group[BANK_TEMPLATES_MAX]; // Registry group for each template
+static int32_t * bank_registry[BANK_TEMPLATES_MAX];
+static uint32_t  bank_registry_size[BANK_TEMPLATES_MAX];
+
 list_type bank_list;
 list_type bank_list_summarized;
 
+// Bank lists, area lists and other bank storage for the current run, released
+// all at once in banks_cleanup(). Area indexes are the exception (on the heap).
+static arena_type banks_arena;
+
 #define AREA_MANUAL_QUEUE_SZ  20
 int area_manual_queue_count = 0;
 area_item areas_manual_queue[AREA_MANUAL_QUEUE_SZ];
 
+// Arena for per-run bank storage, released by banks_cleanup()
+arena_type * banks_get_arena(void) {
+    return &banks_arena;
+}
+
+
 // Initialize the main banklist
 void banks_init(void) {
 
-    list_init(&bank_list, sizeof(bank_item));
-    list_init(&bank_list_summarized, sizeof(bank_item));
+    // Web mode calls main() repeatedly without exiting, drop anything left from a previous run
+    banks_cleanup();
+
+    str_intern_init();
+    area_manual_queue_count = 0; // Queued names are interned, so don't carry them over between runs
+
+    arena_init(&banks_arena);
+    list_init_arena(&bank_list, sizeof(bank_item), &banks_arena);
+    list_init_arena(&bank_list_summarized, sizeof(bank_item), &banks_arena);
+}
+
+
+// Clear all entries in the bank registry
+static void bank_registry_reset(void) {
+
+    for (int c = 0; c < BANK_TEMPLATES_MAX; c++) {
+        if (bank_registry[c]) free(bank_registry[c]);
+        bank_registry[c] = NULL;
+        bank_registry_size[c] = 0;
+    }
+}
+
+
+// Returns a pointer to the bank_list index slot for a template and bank number
+static int32_t * bank_registry_get_slot(int template_idx, uint32_t bank_num) {
+
+    int group = template_bank_group[template_idx];
+
+    // Grow the group's array to fit the bank number if needed
+    if (bank_num >= bank_registry_size[group]) {
+        uint32_t new_size = bank_num + BANK_REGISTRY_GROW;
+        int32_t * p_new = (int32_t *)realloc(bank_registry[group], new_size * sizeof(int32_t));
+        if (!p_new) {
+            log_error("ERROR: Failed to allocate memory for bank registry!\n");
+            exit(EXIT_FAILURE);
+        }
+        for (uint32_t c = bank_registry_size[group]; c < new_size; c++)
+            p_new[c] = BANK_REGISTRY_EMPTY;
+
+        bank_registry[group] = p_new;
+        bank_registry_size[group] = new_size;
+    }
+
+    return &(bank_registry[group][bank_num]);
 }
 
 
@@ -47,16 +156,80 @@ void banks_cleanup(void) {
     bank_item * banks = (bank_item *)bank_list.p_array;
     int c;
 
-    for (c = 0; c < bank_list.count; c++) {
-        list_cleanup(&(banks[c].area_list));
-    }
+    bank_registry_reset();
+
+    for (c = 0; c < bank_list.count; c++)
+        hash_index_cleanup(&(banks[c].area_index));
+
+    banks = (bank_item *)bank_list_summarized.p_array;
+    for (c = 0; c < bank_list_summarized.count; c++)
+        hash_index_cleanup(&(banks[c].area_index));
+
+    // Everything else is in the arena
     list_cleanup(&bank_list);
+    list_cleanup(&bank_list_summarized);
+    arena_release(&banks_arena);
+
+    str_intern_cleanup();
+}
+
+
+// Build the page table and masks for looking up bank templates
+static void bank_templates_index(void) {
+
+    memset(template_page_masks, 0, sizeof(template_page_masks));
+    template_mask_all = 0;
+    template_mask_sms_gg_LIT = 0;
+    template_mask_sms_gg_DATA = 0;
+
+    for (int c = 0; c < bank_templates_count; c++) {
+        uint32_t mask = (1u << c);
+
+        template_mask_all |= mask;
+
+        // Group templates by start address for the bank registry
+        template_bank_group[c] = c;
+        for (int g = 0; g < c; g++) {
+            if (bank_templates[g].start == bank_templates[c].start) {
+                template_bank_group[c] = g;
+                break;
+            }
+        }
+
+        if (strstr(bank_templates[c].name,"LIT_"))  template_mask_sms_gg_LIT  |= mask;
+        if (strstr(bank_templates[c].name,"DATA_")) template_mask_sms_gg_DATA |= mask;
+
+        for (uint32_t page = TEMPLATE_PAGE(min(bank_templates[c].start, MAX_ADDR_UNBANKED));
+             page <= TEMPLATE_PAGE(min(bank_templates[c].end, MAX_ADDR_UNBANKED)); page++) {
+            template_page_masks[page] |= mask;
+        }
+    }
+}
+
+
+// Returns a mask of templates that may overlap an unbanked address range
+//
+// Candidates still need an exact overlap check
+static uint32_t bank_templates_get_candidates(uint32_t start_unbanked, uint32_t end_unbanked) {
+
+    uint32_t mask = 0;
+
+    // Ranges the page table can't handle get checked against all templates
+    if ((start_unbanked > end_unbanked) || (end_unbanked > MAX_ADDR_UNBANKED))
+        return template_mask_all;
+
+    for (uint32_t page = TEMPLATE_PAGE(start_unbanked); page <= TEMPLATE_PAGE(end_unbanked); page++)
+        mask |= template_page_masks[page];
+
+    return mask;
 }
 
 
 // Load templates used for assigning areas to banks
 void banks_init_templates(void) {
     bank_templates_count = bank_templates_load(bank_templates);
+    bank_templates_index();
+    bank_registry_reset();
 }
 
 
@@ -110,20 +283,23 @@ static void area_clip_to_range(uint32_t start, uint32_t end, area_item * p_area)
 static void area_check_region_overflow(area_item area) {
 
     int c;
+    uint32_t candidates = template_page_masks[TEMPLATE_PAGE(WITHOUT_BANK(area.start))];
 
     // Find bank template the area starts in and check to see
     // whether the area extends past the end of it's memory region.
     //
     // Non-banked areas with banks above them have the upper bound
     // set to the end of the bank above them.
-    for(c = 0; c < bank_templates_count; c++) {
+    while (candidates) {
+        c = bits_lowest_u32(candidates);
+        candidates &= candidates - 1;
 
         // Warn about overflow in any ROM bank GBZ80 areas that cross past the (relative) end of their region
         if ((WITHOUT_BANK(area.start) >= bank_templates[c].start) &&
             (WITHOUT_BANK(area.start) <= bank_templates[c].end) &&
              (area.end   > (BANK_ONLY(area.start) + bank_templates[c].overflow_end))) {
             log_warning("* WARNING: Area %-8s at %5x -> %5x extends past end of memory region at %5x (Overflow by %d bytes)\n",
-                   area.name,
+                   str_intern_get(area.name_id),
                    // BANK_GET_NUM(area.start),
                    area.start, area.end,
                    BANK_ONLY(area.start) + bank_templates[c].overflow_end,
@@ -144,7 +320,7 @@ static bool area_check_underflow(area_item area, bool notify) {
 
         if (notify) {
             log_warning("* WARNING: Area %-8s at %5x -> %5x extends past end of address space at %5x (Underflow error by %d bytes)\n",
-                area.name,
+                str_intern_get(area.name_id),
                 area.start, area.end,
                 BANK_ONLY(area.start) + MAX_ADDR_UNBANKED,
                 area.end - (BANK_ONLY(area.start) + MAX_ADDR_UNBANKED));
@@ -177,14 +353,15 @@ static void areas_check_rom0_overflow(void) {
         for(c=0;c < banks[b].area_list.count; c++) {
 
             if (areas[c].end >= BANK_ADDR_ROM_UPPER_ST) {
-                if ((strcmp(areas[c].name,"_CODE") == 0)         ||
-                    (strcmp(areas[c].name,"_HOME") == 0)        ||
-                    (strcmp(areas[c].name,"_INITIALIZER") == 0) ||
-                    (strcmp(areas[c].name,"_GSINIT") == 0)      ||
-                    (strcmp(areas[c].name,"_GSFINAL") == 0)) {
+                const char * area_name = str_intern_get(areas[c].name_id);
+                if ((strcmp(area_name,"_CODE") == 0)         ||
+                    (strcmp(area_name,"_HOME") == 0)        ||
+                    (strcmp(area_name,"_INITIALIZER") == 0) ||
+                    (strcmp(area_name,"_GSINIT") == 0)      ||
+                    (strcmp(area_name,"_GSFINAL") == 0)) {
 
                     log_warning("* WARNING: Possible overflow beyond Bank 0 for non-banked area %s (0x%x -> 0x%x). \n",
-                        areas[c].name, areas[c].start, areas[c].end);
+                        area_name, areas[c].start, areas[c].end);
                     has_overflow = true;
                 }
             }
@@ -214,32 +391,160 @@ static void area_check_warnings(area_item area, uint32_t size_assigned) {
 }
 
 
-static void area_check_warn_overlap(area_item area_a, area_item area_b) {
+static void area_warn_overlap(const area_item * p_area_a, const area_item * p_area_b, uint32_t overlap_size) {
+
+    log_warning("\n* WARNING: Areas overlapp by %d bytes: Possible bank overflow.\n"
+           "%15s 0x%04x -> 0x%04x (%d bytes%s)\n"
+           "%15s 0x%04x -> 0x%04x (%d bytes%s)\n",
+        overlap_size,
+        str_intern_get(p_area_a->name_id), p_area_a->start, p_area_a->end, RANGE_SIZE(p_area_a->start, p_area_a->end),
+        (p_area_a->exclusive) ? ", EXCLUSIVE" : " ",
+        str_intern_get(p_area_b->name_id), p_area_b->start, p_area_b->end, RANGE_SIZE(p_area_b->start, p_area_b->end),
+        (p_area_b->exclusive) ? ", EXCLUSIVE" : " ");
+
+    if (option_error_on_warning)
+        set_exit_error();
+}
 
+
+// Area address range entry for the overlap sweep
+typedef struct overlap_sweep_item {
+    uint32_t start; // Lowest address of the (unbanked) range
+    uint32_t end;   // Highest address of the (unbanked) range
+    uint32_t area_idx;
+} overlap_sweep_item;
+
+// A pair of overlapping areas, area_a was added to the bank after area_b
+typedef struct overlap_pair {
+    uint32_t area_a_idx;
+    uint32_t area_b_idx;
     uint32_t overlap_size;
+} overlap_pair;
 
-    // HEADER areas almost always overlap, ignore them
-    if ((strstr(area_a.name,"HEADER")) || (strstr(area_b.name,"HEADER")))
-        return;
 
-    // Check to see if an there are overlaps with exclusive areas
-    if (area_a.exclusive || area_b.exclusive) {
-        overlap_size = addrs_get_overlap(WITHOUT_BANK(area_a.start), WITHOUT_BANK(area_a.end),
-                                         WITHOUT_BANK(area_b.start), WITHOUT_BANK(area_b.end));
-        if (overlap_size > 0) {
-            log_warning("\n* WARNING: Areas overlapp by %d bytes: Possible bank overflow.\n"
-                   "%15s 0x%04x -> 0x%04x (%d bytes%s)\n"
-                   "%15s 0x%04x -> 0x%04x (%d bytes%s)\n",
-                overlap_size,
-                area_a.name, area_a.start, area_a.end, RANGE_SIZE(area_a.start, area_a.end),
-                (area_a.exclusive) ? ", EXCLUSIVE" : " ",
-                area_b.name, area_b.start, area_b.end, RANGE_SIZE(area_b.start, area_b.end),
-                (area_b.exclusive) ? ", EXCLUSIVE" : " ");
+static int overlap_sweep_item_compare(const void* a, const void* b) {
 
-            if (option_error_on_warning)
-                set_exit_error();
+    const overlap_sweep_item * p_a = (const overlap_sweep_item *)a;
+    const overlap_sweep_item * p_b = (const overlap_sweep_item *)b;
+
+    if (p_a->start != p_b->start) return (p_a->start < p_b->start) ? -1 : 1;
+    if (p_a->area_idx != p_b->area_idx) return (p_a->area_idx < p_b->area_idx) ? -1 : 1;
+    return 0;
+}
+
+
+static int overlap_pair_compare(const void* a, const void* b) {
+
+    const overlap_pair * p_a = (const overlap_pair *)a;
+    const overlap_pair * p_b = (const overlap_pair *)b;
+
+    if (p_a->area_a_idx != p_b->area_a_idx) return (p_a->area_a_idx < p_b->area_a_idx) ? -1 : 1;
+    if (p_a->area_b_idx != p_b->area_b_idx) return (p_a->area_b_idx < p_b->area_b_idx) ? -1 : 1;
+    return 0;
+}
+
+
+// Check the active areas in the sweep against a new area, and log any
+// exclusive overlaps. Areas which end before the new one starts get dropped.
+static void overlap_sweep_check_active(uint32_t * active, uint32_t * p_active_count, const overlap_sweep_item * p_item,
+                                       const overlap_sweep_item * items, const area_item * areas,
+                                       uint32_t first_new_idx, list_type * p_pairs) {
+    uint32_t keep = 0;
+
+    for (uint32_t c = 0; c < *p_active_count; c++) {
+        const overlap_sweep_item * p_active = &items[active[c]];
+
+        // Sweep is in order of start address, so once expired always expired
+        if (p_active->end < p_item->start)
+            continue;
+        active[keep++] = active[c];
+
+        // Only log pairs which include an area not already checked
+        if (max(p_item->area_idx, p_active->area_idx) < first_new_idx)
+            continue;
+
+        const area_item * p_area_a = &areas[max(p_item->area_idx, p_active->area_idx)];
+        const area_item * p_area_b = &areas[min(p_item->area_idx, p_active->area_idx)];
+        overlap_pair pair;
+
+        pair.overlap_size = addrs_get_overlap(WITHOUT_BANK(p_area_a->start), WITHOUT_BANK(p_area_a->end),
+                                              WITHOUT_BANK(p_area_b->start), WITHOUT_BANK(p_area_b->end));
+        if (pair.overlap_size > 0) {
+            pair.area_a_idx = max(p_item->area_idx, p_active->area_idx);
+            pair.area_b_idx = min(p_item->area_idx, p_active->area_idx);
+            list_additem(p_pairs, &pair);
         }
     }
+    *p_active_count = keep;
+}
+
+
+// Warn about overlaps between areas in a bank where at least one is exclusive
+//
+// Areas are swept in order of start address, keeping a list of the ones
+// still active (not yet ended). Only pairs where at least one area is at
+// or after first_new_idx in the area list get logged, so that areas added
+// later can be checked without repeating earlier warnings.
+//
+// Warnings are logged in the order areas were added to the bank, the later
+// added area of each pair is listed first.
+static void bank_check_overlaps(bank_item * p_bank, uint32_t first_new_idx) {
+
+    area_item * areas = (area_item *)p_bank->area_list.p_array;
+    uint32_t    area_count = p_bank->area_list.count;
+    uint32_t    item_count = 0;
+    uint32_t    active_all_count = 0, active_excl_count = 0;
+    list_type   pairs;
+
+    if (first_new_idx >= area_count)
+        return;
+
+    // Working buffers only last for this check
+    arena_mark mark = arena_get_mark(&banks_arena);
+
+    overlap_sweep_item * items  = (overlap_sweep_item *)arena_alloc(&banks_arena, area_count * sizeof(overlap_sweep_item));
+    uint32_t * active_all  = (uint32_t *)arena_alloc(&banks_arena, area_count * sizeof(uint32_t)); // All areas
+    uint32_t * active_excl = (uint32_t *)arena_alloc(&banks_arena, area_count * sizeof(uint32_t)); // Exclusive areas only
+
+    for (uint32_t c = 0; c < area_count; c++) {
+        // HEADER areas almost always overlap, ignore them
+        if (strstr(str_intern_get(areas[c].name_id),"HEADER"))
+            continue;
+
+        // Use the range between the lowest and highest address, exact
+        // overlap gets checked later (ranges may be zero length or reversed)
+        uint32_t start = WITHOUT_BANK(areas[c].start);
+        uint32_t end   = WITHOUT_BANK(areas[c].end);
+        items[item_count].start    = min(start, end);
+        items[item_count].end      = max(start, end);
+        items[item_count].area_idx = c;
+        item_count++;
+    }
+    qsort(items, item_count, sizeof(overlap_sweep_item), overlap_sweep_item_compare);
+
+    list_init_arena(&pairs, sizeof(overlap_pair), &banks_arena);
+
+    for (uint32_t c = 0; c < item_count; c++) {
+
+        // Exclusive areas are checked against all active areas,
+        // non-exclusive ones only against active exclusive areas
+        if (areas[items[c].area_idx].exclusive) {
+            overlap_sweep_check_active(active_all, &active_all_count, &items[c], items, areas, first_new_idx, &pairs);
+            active_excl[active_excl_count++] = c;
+        } else
+            overlap_sweep_check_active(active_excl, &active_excl_count, &items[c], items, areas, first_new_idx, &pairs);
+
+        active_all[active_all_count++] = c;
+    }
+
+    if (pairs.count > 1)
+        qsort(pairs.p_array, pairs.count, sizeof(overlap_pair), overlap_pair_compare);
+    for (uint32_t c = 0; c < pairs.count; c++) {
+        overlap_pair * p_pair = &(((overlap_pair *)pairs.p_array)[c]);
+        area_warn_overlap(&areas[p_pair->area_a_idx], &areas[p_pair->area_b_idx], p_pair->overlap_size);
+    }
+
+    arena_rewind(&banks_arena, mark);
 }
 
 
@@ -275,148 +580,357 @@ int bank_calc_percent_used(bank_item * p_bank) {
 }
 
 
+// === Bank usage bitmaps ===
+//
+// Banks with an address range up to BANK_USAGE_MAP_MAX_SIZE track which
+// addresses are used by any area in a bitmap, filled in as areas are added.
+// Used bytes and graph buckets can then be counted directly from it,
+// no matter how many areas overlap. Banks without one (such as summarized
+// banks) fall back to calculating from their area list.
+//
+// Once all areas are added, bank_usage_index_build() adds a cumulative
+// count of used addresses before each bitmap word. After that counting
+// the used addresses in any range takes two lookups and two popcounts.
+
+#define USAGE_MAP_WORD_BITS   64
+#define USAGE_MAP_WORDS(bits) (((bits) + (USAGE_MAP_WORD_BITS - 1)) / USAGE_MAP_WORD_BITS)
+
+// Bits set from bit_start to bit_end (inclusive) within a single word
+#define USAGE_MAP_WORD_MASK(bit_start, bit_end) \
+    ((~0ULL << (bit_start)) & (~0ULL >> ((USAGE_MAP_WORD_BITS - 1) - (bit_end))))
+
+
+// Allocate an empty usage bitmap covering start -> end (inclusive)
+static void bank_usage_map_alloc(bank_item * p_bank, uint32_t start, uint32_t end) {
+
+    p_bank->usage_map_start = start;
+    p_bank->usage_map_end   = end;
+    p_bank->p_usage_rank    = NULL;
+
+    p_bank->p_usage_map = (uint64_t *)arena_calloc(&banks_arena, USAGE_MAP_WORDS(RANGE_SIZE(start, end)) * sizeof(uint64_t));
+}
+
+
+static void bank_usage_map_init(bank_item * p_bank) {
+
+    p_bank->p_usage_map  = NULL;
+    p_bank->p_usage_rank = NULL;
+
+    if ((p_bank->end < p_bank->start) || (RANGE_SIZE(p_bank->start, p_bank->end) > BANK_USAGE_MAP_MAX_SIZE))
+        return;
+
+    bank_usage_map_alloc(p_bank, p_bank->start, p_bank->end);
+}
+
+
+// Mark an address range as used, clipped to the usage map range
+static void bank_usage_map_set(bank_item * p_bank, uint32_t start, uint32_t end) {
+
+    start = max(start, p_bank->usage_map_start);
+    end   = min(end,   p_bank->usage_map_end);
+    if (end < start) return;
+
+    // Any cumulative index is now stale
+    p_bank->p_usage_rank = NULL;
+
+    uint32_t bit_start = start - p_bank->usage_map_start;
+    uint32_t bit_end   = end   - p_bank->usage_map_start;
+    uint32_t word_start = bit_start / USAGE_MAP_WORD_BITS;
+    uint32_t word_end   = bit_end   / USAGE_MAP_WORD_BITS;
+
+    if (word_start == word_end) {
+        p_bank->p_usage_map[word_start] |= USAGE_MAP_WORD_MASK(bit_start % USAGE_MAP_WORD_BITS, bit_end % USAGE_MAP_WORD_BITS);
+        return;
+    }
+
+    p_bank->p_usage_map[word_start] |= USAGE_MAP_WORD_MASK(bit_start % USAGE_MAP_WORD_BITS, USAGE_MAP_WORD_BITS - 1);
+    for (uint32_t w = word_start + 1; w < word_end; w++)
+        p_bank->p_usage_map[w] = ~0ULL;
+    p_bank->p_usage_map[word_end] |= USAGE_MAP_WORD_MASK(0, bit_end % USAGE_MAP_WORD_BITS);
+}
+
+
+// Returns number of used addresses before a bit in the usage map (requires the cumulative index)
+static inline uint32_t bank_usage_rank(const bank_item * p_bank, uint32_t bit) {
+
+    uint32_t word = bit / USAGE_MAP_WORD_BITS;
+
+    if ((bit % USAGE_MAP_WORD_BITS) == 0)
+        return p_bank->p_usage_rank[word];
+
+    return p_bank->p_usage_rank[word] +
+           bits_count_u64(p_bank->p_usage_map[word] & USAGE_MAP_WORD_MASK(0, (bit % USAGE_MAP_WORD_BITS) - 1));
+}
+
+
+// Returns number of used addresses in a range, clipped to the usage map range
+static uint32_t bank_usage_map_count(const bank_item * p_bank, uint32_t start, uint32_t end) {
+
+    uint32_t count = 0;
+
+    start = max(start, p_bank->usage_map_start);
+    end   = min(end,   p_bank->usage_map_end);
+    if (end < start) return 0;
+
+    uint32_t bit_start = start - p_bank->usage_map_start;
+    uint32_t bit_end   = end   - p_bank->usage_map_start;
+
+    if (p_bank->p_usage_rank)
+        return bank_usage_rank(p_bank, bit_end + 1) - bank_usage_rank(p_bank, bit_start);
+
+    uint32_t word_start = bit_start / USAGE_MAP_WORD_BITS;
+    uint32_t word_end   = bit_end   / USAGE_MAP_WORD_BITS;
+
+    if (word_start == word_end)
+        return bits_count_u64(p_bank->p_usage_map[word_start] &
+                                    USAGE_MAP_WORD_MASK(bit_start % USAGE_MAP_WORD_BITS, bit_end % USAGE_MAP_WORD_BITS));
+
+    count += bits_count_u64(p_bank->p_usage_map[word_start] &
+                                  USAGE_MAP_WORD_MASK(bit_start % USAGE_MAP_WORD_BITS, USAGE_MAP_WORD_BITS - 1));
+    for (uint32_t w = word_start + 1; w < word_end; w++)
+        count += bits_count_u64(p_bank->p_usage_map[w]);
+    count += bits_count_u64(p_bank->p_usage_map[word_end] & USAGE_MAP_WORD_MASK(0, bit_end % USAGE_MAP_WORD_BITS));
+
+    return count;
+}
+
+
+// Build the cumulative usage index for a bank, call once all areas are added
+//
+// Banks without a usage bitmap (summarized banks) get one here covering
+// .start -> .start + .size_total, filled from their area list, as long
+// as that is no larger than BANK_USAGE_INDEX_MAX_SIZE
+void bank_usage_index_build(bank_item * p_bank) {
+
+    if (!p_bank->p_usage_map) {
+        p_bank->p_usage_rank = NULL;
+        if ((p_bank->size_total == 0) || (p_bank->size_total > BANK_USAGE_INDEX_MAX_SIZE))
+            return;
+
+        bank_usage_map_alloc(p_bank, p_bank->start, p_bank->start + (p_bank->size_total - 1));
+
+        const area_item * areas = (const area_item *)p_bank->area_list.p_array;
+        for (uint32_t c = 0; c < p_bank->area_list.count; c++)
+            bank_usage_map_set(p_bank, areas[c].start, areas[c].end);
+    }
+
+    uint32_t word_count = USAGE_MAP_WORDS(RANGE_SIZE(p_bank->usage_map_start, p_bank->usage_map_end));
+
+    // One extra entry so the range end can be looked up without a special case
+    // (an existing index is the same size, so it gets rebuilt in place)
+    if (!p_bank->p_usage_rank)
+        p_bank->p_usage_rank = (uint32_t *)arena_alloc(&banks_arena, (word_count + 1) * sizeof(uint32_t));
+
+    p_bank->p_usage_rank[0] = 0;
+    for (uint32_t w = 0; w < word_count; w++)
+        p_bank->p_usage_rank[w + 1] = p_bank->p_usage_rank[w] + bits_count_u64(p_bank->p_usage_map[w]);
+}
+
+
 // Calculates amount of space used by areas in a bank.
 // Attempts to merge overlapping areas to avoid
 // counting shared space multiple times.
 //
+// Counted from the bank usage bitmap when there is one. Otherwise uses
+// a single pass union of the (clipped) area ranges. Empty ranges are
+// skipped, each area either extends the current run of overlapping
+// areas or starts a new one.
+//
+// Note: Without a bitmap, areas are left sorted by area_item_compare()
 uint32_t bank_areas_calc_used(bank_item * p_bank, uint32_t clip_start, uint32_t clip_end) {
 
-    area_item * areas = (area_item *)p_bank->area_list.p_array;
-    int c,sub;
+    const area_item * areas = (const area_item *)p_bank->area_list.p_array;
+    uint32_t c;
     uint32_t start, end;
+    uint32_t run_start = 0, run_end = 0;
+    bool     in_run = false;
     uint32_t size_used;
-    area_item t_area, sub_area;
+
+    if (p_bank->p_usage_map)
+        return bank_usage_map_count(p_bank, clip_start, clip_end);
 
     size_used = 0;
 
     // The calculation requires areas to first be
     // sorted ascending by .start addr then by .end addr
-    qsort (p_bank->area_list.p_array, p_bank->area_list.count, sizeof(area_item), area_item_compare);
+    areas_sort((area_item *)p_bank->area_list.p_array, p_bank->area_list.count);
 
-    // Iterate over all areas
-    c = 0;
-    while (c < p_bank->area_list.count) {
+    for (c = 0; c < p_bank->area_list.count; c++) {
 
-        // Copy area so it can be clipped, then clip to param range
-        t_area = areas[c];
-        area_clip_to_range(clip_start, clip_end, &t_area); // clip to param range
+        // Clip to param range (same as area_clip_to_range()),
+        // skip if nothing is left
+        start = max(areas[c].start, clip_start);
+        end   = min(areas[c].end,   clip_end);
+        if (end < start)
+            continue;
 
-        // // Store start/end of range for current area
-        start = t_area.start;
-        end = t_area.end;
+        if (in_run && (start <= run_end)) {
+            // Overlaps the current run, expand it to the new end if needed
+            if (end > run_end)
+                run_end = end;
+        } else {
+            // Store space used by the finished run and start a new one
+            if (in_run)
+                size_used += RANGE_SIZE(run_start, run_end);
+            run_start = start;
+            run_end   = end;
+            in_run    = true;
+        }
+    }
 
-        // Iterate over remaining areas and stop when they cease to overlap
-        sub = c + 1;
-        while (sub < p_bank->area_list.count) {
+    if (in_run)
+        size_used += RANGE_SIZE(run_start, run_end);
 
-            // Copy area so it can be clipped, then clip to param range
-            sub_area = areas[sub];
-            area_clip_to_range(clip_start, clip_end, &sub_area);
+    return size_used;
+}
 
-            // Check for overlap with next entry
-            if (addrs_get_overlap(start, end, sub_area.start, sub_area.end)) {
 
-                // Expand overlapped area to new end size
-                // Just end, start shouldn't be necessary due to expected sorting
-                if (sub_area.end > end) {
-                    end = sub_area.end;
-                }
 
-                // Update main loop to next area after current merged,
-                c = sub;
-            }
-            // Increment to next area to check for overlap
-            sub++;
-        }
-        // Move to next area
-        c++;
+// Lookup key for exact duplicate areas in a bank
+typedef struct area_dup_key {
+    const area_item * p_area;
+    const list_type * p_area_list;
+} area_dup_key;
 
-        // Store space used by updated range
-        size_used += RANGE_SIZE(start, end);
-        // fprintf(stdout,"  * %d, %d Final Size> 0x%04X -> 0x%04X = %d ((%d))\n",c, sub, start, end, RANGE_SIZE(start, end), size_used);
-    }
 
-    return size_used;
+static uint32_t area_dup_hash(const area_item * p_area) {
+
+    return hash_index_hash_u32(p_area->name_id)
+           ^ (p_area->start * 0x9E3779B1U) ^ (p_area->end * 0x85EBCA77U);
+}
+
+
+// Hash index match function: same name and address range
+static bool area_dup_matches(uint32_t area_idx, const void * p_key) {
+
+    const area_dup_key * p_dup_key = (const area_dup_key *)p_key;
+    const area_item * p_area = &(((area_item *)p_dup_key->p_area_list->p_array)[area_idx]);
+
+    return ((p_area->start == p_dup_key->p_area->start) &&
+            (p_area->end   == p_dup_key->p_area->end) &&
+            (p_area->name_id == p_dup_key->p_area->name_id));
+}
+
+
+// Rebuild a bank's duplicate lookup, needed after its area list gets reordered
+static void bank_area_index_rebuild(bank_item * p_bank) {
+
+    area_item * areas = (area_item *)p_bank->area_list.p_array;
+
+    hash_index_cleanup(&(p_bank->area_index));
+    hash_index_init(&(p_bank->area_index));
+    for (uint32_t c = 0; c < p_bank->area_list.count; c++)
+        hash_index_add(&(p_bank->area_index), area_dup_hash(&areas[c]), c);
 }
 
 
+// Returns index of the area a new area duplicates, or the area count if none
+//
+// By default only exact matches (name and range) count. The legacy
+// option (-dS) also counts names which contain an existing area's name.
+static uint32_t bank_find_duplicate_area(bank_item * p_bank, const area_item * p_area, uint32_t * p_hash) {
+
+    area_item * areas = (area_item *)p_bank->area_list.p_array;
+    area_dup_key key;
+    int32_t area_idx;
+
+    if (option_suppress_duplicates == true) {
+        if (option_duplicates_substring) {
+            for (uint32_t c = 0; c < p_bank->area_list.count; c++) {
+                if ((strstr(str_intern_get(p_area->name_id), str_intern_get(areas[c].name_id))) &&
+                    (p_area->start == areas[c].start) &&
+                    (p_area->end == areas[c].end))
+                    return c;
+            }
+        } else {
+            key.p_area = p_area;
+            key.p_area_list = &(p_bank->area_list);
+            *p_hash = area_dup_hash(p_area);
+            area_idx = hash_index_find(&(p_bank->area_index), *p_hash, area_dup_matches, &key);
+            if (area_idx != HASH_INDEX_NOT_FOUND)
+                return area_idx;
+        }
+    }
+    return p_bank->area_list.count;
+}
+
 
 // Add an area to a bank's list of areas
 static void bank_add_area(bank_item * p_bank, area_item area) {
 
-    area_item * areas = (area_item *)p_bank->area_list.p_array;
-    int c;
+    uint32_t dup_idx;
+    uint32_t hash = 0;
 
     // Make sure the area length/size is set
     area.length = RANGE_SIZE(area.start, area.end);
 
     // Check for duplicate entries
     // (happens due to paginating in .map file)
-    for(c=0;c < p_bank->area_list.count; c++) {
-        // Abort add if it's already present
-        if (option_suppress_duplicates == true) {
-            if ((strstr(area.name, areas[c].name)) &&
-                (area.start == areas[c].start) &&
-                (area.end == areas[c].end)) {
-                return;
-            }
-        }
+    // Overlaps get checked later by bank_check_overlaps()
+    dup_idx = bank_find_duplicate_area(p_bank, &area, &hash);
 
-        area_check_warn_overlap(area, areas[c]);
-    }
+    // Abort add if it's already present
+    if (dup_idx != p_bank->area_list.count)
+        return;
 
     // no match was found, add area
     list_additem(&(p_bank->area_list), &area);
     p_bank->size_used += area.length;
+
+    if (p_bank->p_usage_map)
+        bank_usage_map_set(p_bank, area.start, area.end);
+
+    if ((option_suppress_duplicates == true) && !option_duplicates_substring)
+        hash_index_add(&(p_bank->area_index), hash, p_bank->area_list.count - 1);
 }
 
 
 // Add/Update a bank with an area entry
-static void banklist_addto(bank_item bank_template, area_item area, int bank_num) {
+static void banklist_addto(int template_idx, area_item area, int bank_num) {
 
-    int c;
-    bank_item * banks = (bank_item *)bank_list.p_array;
+    const bank_item * p_template = &(bank_templates[template_idx]);
+    int32_t * p_bank_idx;
     bank_item newbank;
 
     // Strip bank indicator bits and limit area range to within bank
     area.start = area.start_unbanked;
     area.end = area.end_unbanked;
-    area_clip_to_range(bank_template.start, bank_template.end, &area);
-
-    // Check to see if key matches any entries,
-    for (c=0; c < bank_list.count; c++) {
+    area_clip_to_range(p_template->start, p_template->end, &area);
 
-        // If a match was found, update it
-        if ((bank_template.start == banks[c].start) &&
-            (bank_num == banks[c].bank_num)) {
+    // Check to see if there's already a bank for the key, if so update it
+    p_bank_idx = bank_registry_get_slot(template_idx, bank_num);
+    if (*p_bank_idx != BANK_REGISTRY_EMPTY) {
 
-            // Append area
-            bank_add_area(&(banks[c]), area);
-            return;
-        }
+        // Append area
+        bank_add_area(&(((bank_item *)bank_list.p_array)[*p_bank_idx]), area);
+        return;
     }
 
     // No match was found, initialize new bank
 
     // Copy bank info from template
-    newbank = bank_template;
+    newbank = *p_template;
 
     // Update size used, total size and append bank name if needed
     newbank.size_used = 0;
-    newbank.size_total = RANGE_SIZE(bank_template.start, bank_template.end);
+    newbank.size_total = RANGE_SIZE(p_template->start, p_template->end);
     newbank.bank_num = bank_num;
 
     // Don't append bank name for merged banks
-    if ((bank_template.is_banked == BANKED_YES) && (!bank_template.is_merged_bank))  {
-        if (snprintf(newbank.name, sizeof(newbank.name), "%s%d", bank_template.name, bank_num) > sizeof(newbank.name))
+    if ((p_template->is_banked == BANKED_YES) && (!p_template->is_merged_bank))  {
+        if (snprintf(newbank.name, sizeof(newbank.name), "%s%d", p_template->name, bank_num) > sizeof(newbank.name))
             log_warning("Warning: truncated bank name to :%s\n", newbank.name);
     }
 
     // Initialize new bank's area list and add the area
-    list_init(&(newbank.area_list), sizeof(area_item));
+    list_init_arena(&(newbank.area_list), sizeof(area_item), &banks_arena);
+    hash_index_init(&(newbank.area_index));
+    bank_usage_map_init(&newbank);
+    newbank.p_area_order = NULL;
     bank_add_area(&newbank, area);
 
     // Now add the new bank to the main list
+    *p_bank_idx = bank_list.count;
     list_additem(&bank_list, &newbank);
 }
 
@@ -439,21 +953,23 @@ static void area_calc_unbanked_range(area_item * p_area) {
 }
 
 
-// Returns true if the template should be skipped
+// Returns mask of templates to skip for an area
 //
 // On GBDK SMS/GG the banked LIT_ and DATA_ areas get mapped into the
 // same memory region (only one active at a time) : 0x8000 - 0xBFFF
 //
 // So skip the template of one type if the area is of the other type
-bool banks_sms_gg_checkskip_template(bool sms_gg_is_banked_DATA, bool sms_gg_is_banked_LIT, char * template_name) {
-    if (sms_gg_is_banked_DATA) {
-        if (strstr(template_name,"LIT_"))
-            return true;
-    } else if (sms_gg_is_banked_LIT) {
-        if (strstr(template_name,"DATA_"))
-            return true;
-    }
-    return false;
+static uint32_t banks_sms_gg_get_skip_templates(const char * area_name) {
+
+    if (get_option_platform() != OPT_PLAT_SMS_GG_GBDK)
+        return 0;
+
+    if (strstr(area_name,"DATA_"))
+        return template_mask_sms_gg_LIT;
+    else if (strstr(area_name,"LIT_"))
+        return template_mask_sms_gg_DATA;
+
+    return 0;
 }
 
 // Check to see if an area overlaps with any of the bank templates.
@@ -465,28 +981,22 @@ void banks_check(area_item area) {
     uint32_t size_used;
     uint32_t size_assigned = 0;
     int      bank_num;
+    uint32_t candidates;
 
     // Set the unbanked address range for comparison
     // with (unbanked) bank templates
     area_calc_unbanked_range(&area);
 
-    // On GBDK SMS/GG the banked LIT_ and DATA_ areas get mapped into the
-    // same memory region (only one active at a time) : 0x8000 - 0xBFFF
-    // TODO: kind of sloppy, could be moved to a function
-    bool sms_gg_is_banked_DATA = false;
-    bool sms_gg_is_banked_LIT  = false;
-    if ((get_option_platform() == OPT_PLAT_SMS_GG_GBDK) && strstr(area.name,"DATA_"))
-        sms_gg_is_banked_DATA = true;
-    if ((get_option_platform() == OPT_PLAT_SMS_GG_GBDK) && strstr(area.name,"LIT_"))
-        sms_gg_is_banked_LIT = true;
-
-    // Loop through all banks and log any that overlap
-    // (may be more than one)
-    for(c = 0; c < bank_templates_count; c++) {
+    // Only templates on the pages the area covers can overlap it.
+    // Skip LIT_X banked template if this is a DATA_X area (and same for inverse)
+    candidates = bank_templates_get_candidates(area.start_unbanked, area.end_unbanked)
+                 & ~banks_sms_gg_get_skip_templates(str_intern_get(area.name_id));
 
-        // Skip LIT_X banked template if this is a DATA_X area (and same for inverse)
-        if (banks_sms_gg_checkskip_template(sms_gg_is_banked_DATA, sms_gg_is_banked_LIT, bank_templates[c].name))
-            continue;
+    // Loop through candidate banks in template order and log any that overlap
+    // (may be more than one)
+    while (candidates) {
+        c = bits_lowest_u32(candidates);
+        candidates &= candidates - 1;
 
         // Check a given ROM/RAM bank template for overlap
         size_used = addrs_get_overlap(bank_templates[c].start, bank_templates[c].end,
@@ -504,7 +1014,7 @@ void banks_check(area_item area) {
             bank_num = BANK_GET_NUM(addr_start_banknum);
 
             // Area range added to bank will get clipped to bank range
-            banklist_addto(bank_templates[c], area, bank_num);
+            banklist_addto(c, area, bank_num);
             size_assigned += size_used; // Log space assigned to bank
 
             // Only allow overflow to other banks if first bank is non-banked
@@ -553,7 +1063,7 @@ bool area_manual_queue(char * arg_str) {
     if (cols == ARG_AREA_REC_COUNT_MATCH) {
         area_item * p_area_to_queue = &areas_manual_queue[area_manual_queue_count++];
 
-        snprintf(p_area_to_queue->name, sizeof(p_area_to_queue->name), "%s", p_words[1]);   // [1] Area Name
+        p_area_to_queue->name_id = str_intern(p_words[1]);                     // [1] Area Name
         p_area_to_queue->start = strtol(p_words[2], NULL, 16);                  // [2] Area Hex Address Start
         p_area_to_queue->end   = p_area_to_queue->start + strtol(p_words[3], NULL, 16) - 1; // Start + [3] Hex Size - 1 = Area End
         p_area_to_queue->exclusive = (p_words[0][0] == 'e') ? true : false;        // [0] shared/exclusive
@@ -576,25 +1086,153 @@ static int area_item_compare(const void* a, const void* b) {
         return (((area_item *)a)->end < ((area_item *)b)->end) ? -1 : 1;
 
     // If above match, then sort based on name
-    return strcmp(((area_item *)a)->name, ((area_item *)b)->name);
+    if (((area_item *)a)->name_id == ((area_item *)b)->name_id)
+        return 0;
+    return strcmp(str_intern_get(((area_item *)a)->name_id), str_intern_get(((area_item *)b)->name_id));
 
 }
 
 
-// qsort compare rule function: sort by size descending first, then name
-static int area_item_compare_size_desc(const void* a, const void* b) {
+#define AREA_RADIX_SORT_MIN 32 // Fewer areas than this just use qsort()
+#define AREA_RADIX_BYTES    8  // Bytes in an area sort key
+#define AREA_TIE_INSERT_MAX 16 // Longer runs of areas with the same address range use qsort()
+
+typedef struct area_sort_key {
+    uint64_t key; // .start in the upper 32 bits, .end in the lower 32
+    uint32_t idx; // Area index before sorting
+} area_sort_key;
+
 
-    if (((area_item *)a)->length != ((area_item *)b)->length)
-        return (((area_item *)a)->length < ((area_item *)b)->length) ? 1 : -1;
+// Areas the keys being sorted by area_sort_key_compare() refer to, qsort() has no context param
+static const area_item * area_sort_areas;
+
+// qsort compare rule function for sort keys, same order as area_item_compare()
+static int area_sort_key_compare(const void* a, const void* b) {
+
+    return area_item_compare(&area_sort_areas[((const area_sort_key *)a)->idx],
+                             &area_sort_areas[((const area_sort_key *)b)->idx]);
+}
+
+
+// Sort areas into area_item_compare() order
+//
+// Areas get an LSD radix sort (one byte per pass) on their start and end
+// address packed into a 64 bit key. Passes where every key has the same
+// byte value are skipped, which is most of the upper address bytes.
+// Names are only compared for runs of areas with the same address range.
+static void areas_sort(area_item * areas, uint32_t count) {
+
+    if (count < AREA_RADIX_SORT_MIN) {
+        if (count > 1)
+            qsort(areas, count, sizeof(area_item), area_item_compare);
+        return;
+    }
+
+    arena_mark      mark = arena_get_mark(&banks_arena);
+    area_sort_key * keys     = (area_sort_key *)arena_alloc(&banks_arena, count * sizeof(area_sort_key));
+    area_sort_key * keys_tmp = (area_sort_key *)arena_alloc(&banks_arena, count * sizeof(area_sort_key));
+    uint32_t (*byte_counts)[256] = (uint32_t (*)[256])arena_calloc(&banks_arena, AREA_RADIX_BYTES * 256 * sizeof(uint32_t));
+
+    // Build keys and count byte values for every pass at once
+    for (uint32_t c = 0; c < count; c++) {
+        keys[c].key = ((uint64_t)areas[c].start << 32) | areas[c].end;
+        keys[c].idx = c;
+        for (int b = 0; b < AREA_RADIX_BYTES; b++)
+            byte_counts[b][(keys[c].key >> (b * 8)) & 0xFFU]++;
+    }
+
+    for (int b = 0; b < AREA_RADIX_BYTES; b++) {
+        uint32_t * p_pos = byte_counts[b];
+
+        // Skip if all keys share this byte value, order wouldn't change
+        if (p_pos[(keys[0].key >> (b * 8)) & 0xFFU] == count)
+            continue;
+
+        // Convert counts to output positions, then scatter (stable)
+        uint32_t pos = 0;
+        for (int v = 0; v < 256; v++) {
+            uint32_t value_count = p_pos[v];
+            p_pos[v] = pos;
+            pos += value_count;
+        }
+        for (uint32_t c = 0; c < count; c++)
+            keys_tmp[p_pos[(keys[c].key >> (b * 8)) & 0xFFU]++] = keys[c];
+
+        area_sort_key * p_swap = keys;
+        keys = keys_tmp;
+        keys_tmp = p_swap;
+    }
+
+    // Order runs with the same address range by name. Runs are usually
+    // short and get an insertion sort, long ones (many aliases or labels
+    // at one address) use qsort() to avoid O(n^2) name compares.
+    area_sort_areas = areas;
+    uint32_t run_start = 0;
+    for (uint32_t c = 1; c <= count; c++) {
+        if ((c < count) && (keys[c].key == keys[run_start].key))
+            continue;
+
+        if ((c - run_start) > AREA_TIE_INSERT_MAX) {
+            qsort(&keys[run_start], c - run_start, sizeof(area_sort_key), area_sort_key_compare);
+        } else {
+            for (uint32_t i = run_start + 1; i < c; i++) {
+                area_sort_key cur = keys[i];
+                uint32_t      j = i;
+                while ((j > run_start) && (area_item_compare(&areas[keys[j - 1].idx], &areas[cur.idx]) > 0)) {
+                    keys[j] = keys[j - 1];
+                    j--;
+                }
+                keys[j] = cur;
+            }
+        }
+        run_start = c;
+    }
+
+    // Move the areas into sorted order
+    area_item * areas_sorted = (area_item *)arena_alloc(&banks_arena, count * sizeof(area_item));
+    for (uint32_t c = 0; c < count; c++)
+        areas_sorted[c] = areas[keys[c].idx];
+    memcpy(areas, areas_sorted, count * sizeof(area_item));
+
+    arena_rewind(&banks_arena, mark);
+}
+
+
+// Area list being sorted by area_order_compare_size_desc(), qsort() has no context param
+static const area_item * area_order_areas;
+
+// qsort compare rule function for area indexes: sort by size descending first, then name
+static int area_order_compare_size_desc(const void* a, const void* b) {
+
+    const area_item * p_area_a = &area_order_areas[*(const uint32_t *)a];
+    const area_item * p_area_b = &area_order_areas[*(const uint32_t *)b];
+
+    if (p_area_a->length != p_area_b->length)
+        return (p_area_a->length < p_area_b->length) ? 1 : -1;
     else
-        return strcmp(((area_item *)a)->name, ((area_item *)b)->name);
+        return strcmp(str_intern_get(p_area_a->name_id), str_intern_get(p_area_b->name_id));
 }
 
 
-// qsort compare rule function: sort by start address ascending
-static int area_item_compare_addr_asc(const void* a, const void* b) {
+// Build the display order of a bank's areas for the area sort option
+//
+// Area records stay in address order (which is also the default and -aA
+// display order) and only an array of indexes gets sorted for other orders.
+// .p_area_order is left NULL when the display order is the address order.
+static void bank_area_order_build(bank_item * p_bank) {
+
+    p_bank->p_area_order = NULL;
+
+    if ((get_option_area_sort() != OPT_AREA_SORT_SIZE_DESC) || (p_bank->area_list.count == 0))
+        return;
+
+    p_bank->p_area_order = (uint32_t *)arena_alloc(&banks_arena, p_bank->area_list.count * sizeof(uint32_t));
 
-    return (((area_item *)a)->start < ((area_item *)b)->start) ? -1 : 1;
+    for (uint32_t c = 0; c < p_bank->area_list.count; c++)
+        p_bank->p_area_order[c] = c;
+
+    area_order_areas = (const area_item *)p_bank->area_list.p_array;
+    qsort(p_bank->p_area_order, p_bank->area_list.count, sizeof(uint32_t), area_order_compare_size_desc);
 }
 
 
@@ -614,6 +1252,52 @@ static int bank_item_compare(const void* a, const void* b) {
 
 
 
+// Merge two area_item_compare() sorted runs: [0, first_new_idx) and [first_new_idx, count)
+static void areas_merge_sorted(area_item * areas, uint32_t first_new_idx, uint32_t count) {
+
+    // Move the existing areas out of the way and merge back into the list.
+    // Output can never overtake the unread new areas since it only grows
+    // by one for each area read.
+    arena_mark  mark = arena_get_mark(&banks_arena);
+    area_item * areas_old = (area_item *)arena_alloc(&banks_arena, first_new_idx * sizeof(area_item));
+    memcpy(areas_old, areas, first_new_idx * sizeof(area_item));
+
+    uint32_t idx_old = 0, idx_new = first_new_idx, idx_out = 0;
+    while ((idx_old < first_new_idx) && (idx_new < count)) {
+        if (area_item_compare(&areas[idx_new], &areas_old[idx_old]) < 0)
+            areas[idx_out++] = areas[idx_new++];
+        else
+            areas[idx_out++] = areas_old[idx_old++];
+    }
+    while (idx_old < first_new_idx)
+        areas[idx_out++] = areas_old[idx_old++];
+    // Any remaining new areas are already in place
+
+    arena_rewind(&banks_arena, mark);
+}
+
+
+// Merge areas added from first_new_idx onward into the
+// area_item_compare() sorted areas before them
+//
+// Only the new areas need sorting, then both runs are merged in one pass
+static void bank_areas_merge_new(bank_item * p_bank, uint32_t first_new_idx) {
+
+    area_item * areas = (area_item *)p_bank->area_list.p_array;
+    uint32_t    count = p_bank->area_list.count;
+
+    if (first_new_idx >= count) return;
+
+    areas_sort(&areas[first_new_idx], count - first_new_idx);
+
+    if ((first_new_idx > 0) && (area_item_compare(&areas[first_new_idx - 1], &areas[first_new_idx]) > 0))
+        areas_merge_sorted(areas, first_new_idx, count);
+
+    // Sorting moved areas around, duplicate lookup needs updating
+    bank_area_index_rebuild(p_bank);
+}
+
+
 // Fill in gaps between symbols with "?" symbols --TODO: rename function to symbols
 static void bank_fill_area_gaps_with_unknown(void) {
 
@@ -622,37 +1306,45 @@ static void bank_fill_area_gaps_with_unknown(void) {
     uint32_t last_addr, cur_addr;
     int c, b, t_area_count;
     area_item area;
+    uint32_t name_id_unknown = str_intern("-?-");
 
     for (c = 0; c < bank_list.count; c++) {
         // Load the area list for the bank
         areas = (area_item *)banks[c].area_list.p_array;
 
-        // Sort areas by ascending address so that gaps can be found
-        qsort (banks[c].area_list.p_array, banks[c].area_list.count, sizeof(area_item), area_item_compare_addr_asc);
+        // Areas are already sorted by ascending address (see banklist_finalize_and_show()),
+        // but the duplicate lookup needs rebuilding after that reordering
+        bank_area_index_rebuild(&banks[c]);
 
         t_area_count = banks[c].area_list.count; // Temp area count to avoid processing newly added areas
         last_addr = banks[c].start;         // Set last to start of current bank
 
         for(b = 0; b < t_area_count; b++) {
 
-            if ((banks_display_headers) || !(strstr(areas[b].name,"HEADER"))) {
+            if ((banks_display_headers) || !(strstr(str_intern_get(areas[b].name_id),"HEADER"))) {
 
                 cur_addr = areas[b].start;
 
                 if (cur_addr > last_addr + 1) {
 
-                    snprintf(area.name, sizeof(area.name), "-?-");
+                    area.name_id = name_id_unknown;
                     area.start  = last_addr + 1;
                     area.end    = cur_addr - 1;
                     area.length = area.end - area.start + 1;
                     area.exclusive = false;
                     bank_add_area(&(banks[c]), area); // Add to bank, skip bank_check since parent bank is known
+                    // Adding may have reallocated the area list, reload it
+                    areas = (area_item *)banks[c].area_list.p_array;
                 }
 
                 // Update previous area reference
                 last_addr = areas[b].end;
             }
         }
+
+        // Check the newly added areas for overlaps, then merge them into the sorted ones
+        bank_check_overlaps(&banks[c], t_area_count);
+        bank_areas_merge_new(&banks[c], t_area_count);
     }
 }
 
@@ -674,22 +1366,30 @@ void banklist_finalize_and_show(void) {
     int c;
 
     // Sort banks by start address then bank num
-    qsort (bank_list.p_array, bank_list.count, sizeof(bank_item), bank_item_compare);
+    // (bank registry indexes are no longer valid after this, empty lists have no array to sort)
+    if (bank_list.count > 1)
+        qsort (bank_list.p_array, bank_list.count, sizeof(bank_item), bank_item_compare);
+    bank_registry_reset();
+
+    // Warn about any overlapping exclusive areas
+    // (before sorting so warnings list areas in the order they were added)
+    for (c = 0; c < bank_list.count; c++)
+        bank_check_overlaps(&banks[c], 0);
+
+    // Sort areas in each bank by address. This is the only time the area
+    // records get sorted, other display orders are views into it
+    // (see bank_area_order_build()), and later steps rely on it.
+    for (c = 0; c < bank_list.count; c++)
+        areas_sort((area_item *)banks[c].area_list.p_array, banks[c].area_list.count);
 
     if (get_option_input_source() == OPT_INPUT_SRC_CDB)
         bank_fill_area_gaps_with_unknown();
 
     for (c = 0; c < bank_list.count; c++) {
-        // Sort areas in bank and calculate usage
+        bank_usage_index_build(&banks[c]);
         banks[c].size_used = bank_areas_calc_used(&banks[c], banks[c].start, banks[c].end);
         banks[c].hidden = bank_name_check_hidden(banks[c].name);
-
-        if (get_option_area_sort() == OPT_AREA_SORT_SIZE_DESC)
-            qsort (banks[c].area_list.p_array, banks[c].area_list.count, sizeof(area_item), area_item_compare_size_desc);
-        else if (get_option_area_sort() == OPT_AREA_SORT_ADDR_ASC)
-            qsort (banks[c].area_list.p_array, banks[c].area_list.count, sizeof(area_item), area_item_compare_addr_asc);
-        else
-            qsort (banks[c].area_list.p_array, banks[c].area_list.count, sizeof(area_item), area_item_compare);
+        bank_area_order_build(&banks[c]);
     }
 
     areas_check_rom0_overflow();
@@ -718,6 +1418,10 @@ void banklist_finalize_and_show(void) {
 // Attempts to merge overlapping areas to avoid
 // counting shared space multiple times.
 //
+// Banks with a usage index (see bank_usage_index_build()) count each
+// bucket with a constant time lookup, so graphs at any resolution
+// need no allocation or sorting. Others merge their (already sorted) areas.
+//
 // Avoids losing some address slots to integer rounding errors (when
 // bucket_count is an imperfect divisor of range size) by using floats,
 // with the trade-off that bucket size is slightly variable between buckets.
@@ -726,76 +1430,67 @@ void bank_areas_split_to_buckets(bank_item * p_bank, uint32_t range_start, uint3
     float bucket_size  = (float)range_size / (float)bucket_count;
     if (bucket_size == 0.0) return;
 
-    uint32_t range_end = range_start + (range_size - 1);
     uint32_t bucket_start, bucket_end;
     uint32_t bucket_id;
-    uint32_t start, end;
 
-    // Make a working copy of the bank and it's areas to modify since the
-    // required sorting of areas would override any user level sorting option
-    bank_item bank_copy = *p_bank;
-    bank_copy.area_list.p_array = (void *)malloc(bank_copy.area_list.size * bank_copy.area_list.typesize);
-    if (!bank_copy.area_list.p_array) {
-        log_error("Error: Failed to reallocate memory for list!\n");
-        exit(EXIT_FAILURE);
+    // With a usage bitmap each bucket can be counted directly
+    if (p_bank->p_usage_map) {
+        for (bucket_id = 0; bucket_id < bucket_count; bucket_id++) {
+            bucket_start = (uint32_t)(bucket_size * (float)bucket_id) + range_start;
+            bucket_end   = (uint32_t)((bucket_size * ((float)bucket_id + 1.0)) - 1.0) + range_start;
+            p_buckets[bucket_id] += bank_usage_map_count(p_bank, bucket_start, bucket_end);
+        }
+        return;
     }
-    // Copy main list of areas to copy of bank for modification
-    memcpy(bank_copy.area_list.p_array, p_bank->area_list.p_array,
-           bank_copy.area_list.size * bank_copy.area_list.typesize);
-
-    area_item * areas = (area_item *)bank_copy.area_list.p_array;
 
-    // The calculation requires areas to be sorted ascending by .start addr then by .end addr
-    qsort (bank_copy.area_list.p_array, bank_copy.area_list.count, sizeof(area_item), area_item_compare);
+    uint32_t run_start, run_end;
+    uint32_t count = p_bank->area_list.count;
+    uint32_t c = 0;
 
-    // Iterate over all areas, splitting areas into any buckets they overlaps with
-    int c = 0;
-    uint32_t highest_addr_used = range_start;
-    while (c < bank_copy.area_list.count) {
+    // Areas are kept sorted ascending by .start addr then by .end addr
+    // (see banklist_finalize_and_show() and banklist_collapse_to_summary())
+    const area_item * areas = (const area_item *)p_bank->area_list.p_array;
 
-        // Only process areas not entirely covered by previous area
-        // Works since areas are sorted so current will never start before previous,
-        // and highest_addr_used is set to max from all processed areas so far
-        if (areas[c].end > highest_addr_used) {
+    // Merge overlapping areas into runs the same way as bank_areas_calc_used(),
+    // then split each run into any buckets it overlaps with.
+    while (c < count) {
 
-            // Calc starting bucket to skip non-overlapping ones
-            bucket_id = ((areas[c].start - range_start) / bucket_size);
-
-            // Break out if bucket exceeds range or
-            while (bucket_id < bucket_count) {
-
-                bucket_start = (uint32_t)(bucket_size * (float)bucket_id) + range_start;
-                bucket_end   = (uint32_t)((bucket_size * ((float)bucket_id + 1.0)) - 1.0) + range_start;
+        // Skip empty ranges, otherwise start a new run with the area
+        if (areas[c].end < areas[c].start) {
+            c++;
+            continue;
+        }
+        run_start = areas[c].start;
+        run_end   = areas[c].end;
+
+        // Extend the run with any following areas that overlap it
+        for (c++; c < count; c++) {
+            if (areas[c].end < areas[c].start)
+                continue;
+            if (areas[c].start > run_end)
+                break;
+            if (areas[c].end > run_end)
+                run_end = areas[c].end;
+        }
 
-                // Break out of bucket updates for this area once past area end
-                if (bucket_start > areas[c].end)
-                    break;
+        // Calc starting bucket to skip non-overlapping ones
+        bucket_id = (run_start > range_start) ? ((run_start - range_start) / bucket_size) : 0;
 
-                // Factor in highest addr used if it's been initialized
-                // Use that to avoid counting parts where areas overlap multiple times.
-                // +1 since start should be the address _after_ the highest used
-                if (highest_addr_used != bucket_start)
-                    start = max(bucket_start, highest_addr_used + 1);
+        // Break out if bucket exceeds range
+        while (bucket_id < bucket_count) {
 
-                // Clip area to be within the bucket range
-                start = max(areas[c].start, bucket_start);
-                end   = min(areas[c].end,   bucket_end);
+            bucket_start = (uint32_t)(bucket_size * (float)bucket_id) + range_start;
+            bucket_end   = (uint32_t)((bucket_size * ((float)bucket_id + 1.0)) - 1.0) + range_start;
 
-                if (start <= end)
-                    p_buckets[bucket_id] += (end - start) + 1;
+            // Break out of bucket updates for this run once past run end
+            if (bucket_start > run_end)
+                break;
 
-                // Move to next bucket and track high water mark for end of all areas
-                bucket_id++;
-                highest_addr_used = max(end, highest_addr_used);
+            // Clip run to be within the bucket range
+            if (max(run_start, bucket_start) <= min(run_end, bucket_end))
+                p_buckets[bucket_id] += (min(run_end, bucket_end) - max(run_start, bucket_start)) + 1;
 
-            } // End processing buckets for a given area
+            bucket_id++;
         }
-        // Move to next area
-        c++;
-    }
-
-    if (bank_copy.area_list.p_array) {
-        free(bank_copy.area_list.p_array);
-        bank_copy.area_list.p_array = NULL; // Pointless, but out of habit
     }
 }
@@ -6,6 +6,8 @@
 #define _BANKS_H
 
 #include "list.h"
+#include "hash_index.h"
+#include "arena.h"
 
 #define WRAM_X_MAX_BANKS        7
 
@@ -32,8 +34,6 @@
 #define RANGE_SIZE(MIN, MAX) (MAX - MIN + 1)
 #define UNBANKED_END(start, end)  ((end - start) + WITHOUT_BANK(start))
 
-#define AREA_MAX_STR DEFAULT_STR_LEN
-
 #define BANK_MAX_STR DEFAULT_STR_LEN
 #define BANKED_NO     0
 #define BANKED_YES    1
@@ -47,8 +47,12 @@
 #define HIDDEN_NO          false
 #define HIDDEN_YES         true
 
+// Largest bank address range which gets a usage bitmap
+#define BANK_USAGE_MAP_MAX_SIZE 0x10000U
+// Largest summarized address range which gets one when indexed (2MB bitmap)
+#define BANK_USAGE_INDEX_MAX_SIZE 0x1000000U
+
 #define MINIGRAPH_SIZE (2 * 14) // Number of characters wide (inside edge brackets)
-#define LARGEGRAPH_BYTES_PER_CHAR 16
 
 typedef enum {
     BANK_MEM_TYPE_ROM,
@@ -60,7 +64,7 @@ typedef enum {
 
 
 typedef struct area_item {
-    char     name[AREA_MAX_STR];
+    uint32_t name_id; // Interned name, see str_intern.h
     uint32_t start;
     uint32_t end;
     uint32_t start_unbanked;
@@ -91,6 +95,12 @@ typedef struct bank_item {
 
     // TODO: track overflow bytes and report them in graph
     list_type area_list;
+    hash_index area_index; // Lookup for exact duplicate areas in area_list
+    uint64_t * p_usage_map;  // Optional bitmap of used addresses, one bit per byte (see bank_usage_map_init())
+    uint32_t * p_usage_rank; // Optional count of used addresses before each bitmap word (see bank_usage_index_build())
+    uint32_t usage_map_start;
+    uint32_t usage_map_end;
+    uint32_t * p_area_order; // Optional display order of area_list indexes, NULL for address order (see bank_area_order_build())
 } bank_item;
 
 void area_manual_apply_queued(void);
@@ -100,12 +110,14 @@ int bank_calc_percent_free(bank_item * p_bank);
 int bank_calc_percent_used(bank_item * p_bank);
 
 uint32_t bank_areas_calc_used(bank_item *, uint32_t, uint32_t);
+void bank_usage_index_build(bank_item * p_bank);
 
 void banks_output_show_areas(bool do_show);
 void banks_output_show_headers(bool do_show);
 void banks_output_show_minigraph(bool do_show);
 void banks_output_show_largegraph(bool do_show);
 
+arena_type * banks_get_arena(void);
 void banks_init(void);
 void banks_cleanup(void);
 void banks_init_templates(void);
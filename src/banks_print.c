@@ -12,6 +12,7 @@
 #include "logging.h"
 #include "list.h"
 #include "banks.h"
+#include "str_intern.h"
 #include "banks_print.h"
 #include "banks_color.h"
 
@@ -84,14 +85,9 @@ static void bank_print_graph(bank_item * p_bank, uint32_t num_chars) {
     unsigned int perc_used;
     uint32_t bucket_start, bucket_end;
     uint32_t bucket_id;
-    uint32_t bucket_buf_size = num_chars * sizeof(uint32_t);
+    arena_mark mark = arena_get_mark(banks_get_arena());
 
-    uint32_t * p_buckets = (uint32_t *)malloc(bucket_buf_size);
-    if (p_buckets == NULL) {
-        log_error("Error: Failed to allocate buffer for graph!\n");
-        return;
-    }
-    memset(p_buckets, 0, bucket_buf_size);
+    uint32_t * p_buckets = (uint32_t *)arena_calloc(banks_get_arena(), num_chars * sizeof(uint32_t));
 
     bank_areas_split_to_buckets(p_bank, p_bank->start, p_bank->size_total, num_chars, p_buckets);
 
@@ -115,13 +111,12 @@ static void bank_print_graph(bank_item * p_bank, uint32_t num_chars) {
             fprintf(stdout, "\n");
     }
 
-    if (p_buckets)
-        free(p_buckets);
+    arena_rewind(banks_get_arena(), mark);
 }
 
 
 // Show a large usage graph for each bank
-// Currently 16 bytes per character
+// Default 16 bytes per character (-G:DECBYTES to change)
 static void banklist_print_large_graph(list_type * p_bank_list) {
 
     bank_item * banks = (bank_item *)p_bank_list->p_array;
@@ -134,14 +129,15 @@ static void banklist_print_large_graph(list_type * p_bank_list) {
                                               banks[c].end); // Address Start -> End
             fprintf(stdout,"\n"); // Name
 
-            uint32_t bytes_per_char = LARGEGRAPH_BYTES_PER_CHAR;
+            uint32_t bytes_per_char = get_option_largegraph_bytes_per_char();
 
             // Scale large graph unit size by number of banks it uses for banked items
             // (factoring in whether bank start is 0 or 1 based)
-            if (option_summarized_mode)
+            if ((option_summarized_mode) && (banks[c].bank_num >= banks[c].base_bank_num))
                 bytes_per_char *= ((banks[c].bank_num - banks[c].base_bank_num) + 1);
 
-            bank_print_graph(&banks[c], banks[c].size_total / bytes_per_char);
+            // At least one character, even when bytes per char is larger than the bank
+            bank_print_graph(&banks[c], max(banks[c].size_total / bytes_per_char, 1u));
 
             fprintf(stdout,"End: %s\n",banks[c].name); // Name
         }
@@ -152,14 +148,18 @@ static void banklist_print_large_graph(list_type * p_bank_list) {
 static void bank_print_area(bank_item *p_bank) {
 
     area_item * areas;
-    int b;
+    area_item * p_area;
+    const char * area_name;
+    uint32_t b;
     int hidden_count = 0;
     uint32_t hidden_total = 0;
 
     for(b = 0; b < p_bank->area_list.count; b++) {
 
-        // Load the area list for the bank
+        // Load the area list for the bank, in display order if it has one
         areas = (area_item *)p_bank->area_list.p_array;
+        p_area = (p_bank->p_area_order) ? &areas[p_bank->p_area_order[b]] : &areas[b];
+        area_name = str_intern_get(p_area->name_id);
 
         if (b == 0) {
             fprintf(stdout,"|\n");
@@ -172,19 +172,19 @@ static void bank_print_area(bank_item *p_bank) {
         }
 
         // Don't display headers unless requested
-        if ((banks_display_headers) || !(strstr(areas[b].name,"HEADER"))) {
+        if ((banks_display_headers) || !(strstr(area_name,"HEADER"))) {
 
             // Optionally hide areas below a given size
-            if (areas[b].length >= get_option_area_hide_size()) {
+            if (p_area->length >= get_option_area_hide_size()) {
 
-                fprintf(stdout,"+ %-32s", areas[b].name);           // Name
-                fprintf(stdout,"0x%04X -> 0x%04X",areas[b].start,
-                                                  areas[b].end); // Address Start -> End
-                fprintf(stdout,"%8d", areas[b].length);
+                fprintf(stdout,"+ %-32s", area_name);              // Name
+                fprintf(stdout,"0x%04X -> 0x%04X",p_area->start,
+                                                  p_area->end); // Address Start -> End
+                fprintf(stdout,"%8d", p_area->length);
                 fprintf(stdout,"\n");
             } else {
                 hidden_count++;
-                hidden_total += areas[b].length;
+                hidden_total += p_area->length;
             }
         }
     }
@@ -50,16 +50,7 @@ static void summarize_copy_modified_areas(bank_item * p_dest_bank, const bank_it
         // NO: p_dest_bank->size_used += new_area.length;
         list_additem(&(p_dest_bank->area_list), &new_area);
     }
-
-    // Re-calculate size used in bank, taking overlapped areas into consideration
-    //
-    // For collapsing multiple banked regions with the same address range into
-    // one bank, the address range would need to be scaled upward to accomodate
-    // their larger virtual address range.
-    //
-    // Instead, make the assumption that areas have been previously clipped to be
-    // within allowed ranges so that we don't need a stard/end range check and disable clipping. 
-    p_dest_bank->size_used = bank_areas_calc_used(p_dest_bank, ADDR_NO_CLIP_MIN, ADDR_NO_CLIP_MAX);
+    // Size used gets calculated once all banks are merged, see banklist_collapse_to_summary()
 }
 
 
@@ -69,7 +60,11 @@ static void summarize_copy_bank(bank_item * p_dest_bank, const bank_item * p_src
     // Duplicate bank, re-initialize bank list & copy areas from source
     *p_dest_bank = *p_src_bank;
     p_dest_bank->size_used = 0;
-    list_init(&(p_dest_bank->area_list), sizeof(area_item));
+    p_dest_bank->p_usage_map  = NULL; // Summarized banks get their own usage bitmap once collapsed
+    p_dest_bank->p_usage_rank = NULL;
+    p_dest_bank->p_area_order = NULL; // Summarized areas are shown in address order
+    memset(&(p_dest_bank->area_index), 0, sizeof(p_dest_bank->area_index)); // Source index is for the source areas, start empty
+    list_init_arena(&(p_dest_bank->area_list), sizeof(area_item), banks_get_arena());
     summarize_copy_modified_areas(p_dest_bank, p_src_bank);
 }
 
@@ -218,4 +213,21 @@ void banklist_collapse_to_summary(const list_type * p_bank_list, list_type * p_b
     }
 
     summarize_fixup_sizes_and_names(p_bank_list_summarized);
+
+    banks_summarized = (bank_item *)p_bank_list_summarized->p_array;
+    for (int c = 0; c < p_bank_list_summarized->count; c++) {
+        // Calculate size used in bank, taking overlapped areas into consideration.
+        // This also sorts the merged areas by address.
+        //
+        // For collapsing multiple banked regions with the same address range into
+        // one bank, the address range would need to be scaled upward to accomodate
+        // their larger virtual address range.
+        //
+        // Instead, make the assumption that areas have been previously clipped to be
+        // within allowed ranges so that we don't need a stard/end range check and disable clipping.
+        banks_summarized[c].size_used = bank_areas_calc_used(&banks_summarized[c], ADDR_NO_CLIP_MIN, ADDR_NO_CLIP_MAX);
+
+        // Index usage now that the final summarized size is known
+        bank_usage_index_build(&banks_summarized[c]);
+    }
 }
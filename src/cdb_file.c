@@ -8,20 +8,28 @@
 #include <unistd.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <ctype.h>
+#include <limits.h>
 
 #include "common.h"
 #include "logging.h"
 #include "list.h"
 #include "banks.h"
+#include "hash_index.h"
+#include "str_intern.h"
+#include "file_buffer.h"
+#include "parallel.h"
 #include "cdb_file.h"
 
 
-list_type symbol_list;
+list_type  symbol_list;
+hash_index symbol_index; // Name lookup for symbol_list
 
 #define CDB_L_REC_FUNC_START_GLOBAL 'G'
 #define CDB_L_REC_FUNC_START_LOCAL  'F'
 #define CDB_L_REC_FUNC_END_GLOBAL   "XG"
 #define CDB_L_REC_FUNC_END_LOCAL    "XF"
+#define CDB_L_REC_FUNC_END_LEN      2
 
 // More compelte CDB coverage is affected by this SDCC bug
 // #3662 Adding a function removes const arrays above it from .adb/.cdb output
@@ -100,6 +108,7 @@ list_type symbol_list;
 void cdb_init(void) {
 
     list_init(&symbol_list, sizeof(area_item));
+    hash_index_init(&symbol_index);
 }
 
 
@@ -107,35 +116,101 @@ void cdb_init(void) {
 void cdb_cleanup(void) {
 
     list_cleanup(&symbol_list);
+    hash_index_cleanup(&symbol_index);
 }
 
 
-// Find a matching symbol, if none matches a new one is added and returned
-static int symbollist_get_id_by_name(char * symbol_name) {
+// Text in the file data
+typedef struct cdb_slice {
+    const char * p_str; // Not '\0' terminated
+    uint32_t     len;
+} cdb_slice;
 
-    area_item * symbols = (area_item *)symbol_list.p_array;
-    area_item new_symbol;
 
-    int c;
+// Hash index match function: compare a symbol name ID against a symbol in the list
+static bool symbollist_name_matches(uint32_t symbol_idx, const void * p_key) {
 
-    // Check for matching symbol name
-    for(c=0;c < symbol_list.count; c++) {
-        // Return matching symbol index if present
-        if (strncmp(symbol_name, symbols[c].name, AREA_MAX_STR) == 0) {
-            return c;
-        }
+    return (((area_item *)symbol_list.p_array)[symbol_idx].name_id == *(const uint32_t *)p_key);
+}
+
+
+// Return true if the string slice contains substring
+static bool cdb_slice_contains(cdb_slice str, const char * substr) {
+
+    size_t substr_len = strlen(substr);
+
+    for (uint32_t c = 0; (c + substr_len) <= str.len; c++) {
+        if (memcmp(str.p_str + c, substr, substr_len) == 0) return true;
     }
+    return false;
+}
+
+
+// Parse a number from a string slice, same rules as strtol() for base 10 and 16
+static long cdb_slice_to_long(cdb_slice str, int base) {
+
+    const char * p_chr = str.p_str;
+    const char * p_end = str.p_str + str.len;
+    bool  negative = false;
+    bool  overflow = false;
+    long  value = 0;
+
+    while ((p_chr < p_end) && ((*p_chr == ' ') || ((*p_chr >= '\t') && (*p_chr <= '\r')))) p_chr++;
+
+    if ((p_chr < p_end) && ((*p_chr == '-') || (*p_chr == '+'))) {
+        negative = (*p_chr == '-');
+        p_chr++;
+    }
+
+    // Optional hex prefix, only if followed by a hex digit
+    if ((base == 16) && ((p_end - p_chr) >= 3) && (p_chr[0] == '0') && ((p_chr[1] == 'x') || (p_chr[1] == 'X')) && isxdigit((unsigned char)p_chr[2]))
+        p_chr += 2;
+
+    while (p_chr < p_end) {
+        int digit;
+        if      ((*p_chr >= '0') && (*p_chr <= '9')) digit = *p_chr - '0';
+        else if ((*p_chr >= 'a') && (*p_chr <= 'z')) digit = *p_chr - 'a' + 10;
+        else if ((*p_chr >= 'A') && (*p_chr <= 'Z')) digit = *p_chr - 'A' + 10;
+        else break;
+        if (digit >= base) break;
+
+        if (value > ((LONG_MAX - digit) / base)) overflow = true; // Saturate like strtol()
+        else value = (value * base) + digit;
+        p_chr++;
+    }
+
+    if (overflow) return (negative) ? LONG_MIN : LONG_MAX;
+    return (negative) ? -value : value;
+}
 
-    snprintf(new_symbol.name, sizeof(new_symbol.name), "%s", symbol_name);
+
+// Find a matching symbol, if none matches a new one is added and returned
+//
+// Note: Adding may reallocate the symbol list, so pointers
+//       into it should be retrieved *after* calling this
+static int symbollist_get_id_by_name(cdb_slice symbol_name) {
+
+    area_item new_symbol;
+    uint32_t  name_id = str_intern_len(symbol_name.p_str, symbol_name.len);
+    uint32_t  hash    = hash_index_hash_u32(name_id);
+    int32_t   symbol_id;
+
+    symbol_id = hash_index_find(&symbol_index, hash, symbollist_name_matches, &name_id);
+    // Return matching symbol index if present
+    if (symbol_id != HASH_INDEX_NOT_FOUND)
+        return symbol_id;
+
+    new_symbol.name_id = name_id;
     new_symbol.start  = AREA_VAL_UNSET;
     new_symbol.end    = AREA_VAL_UNSET;
     new_symbol.length = AREA_VAL_UNSET;
-    if (strstr(symbol_name,"HEADER"))
+    if (cdb_slice_contains(symbol_name, "HEADER"))
         new_symbol.exclusive = false; // HEADER symbols almost always overlap, ignore them
     else
         new_symbol.exclusive = option_all_areas_exclusive; // Default is false
 
     list_additem(&symbol_list, &new_symbol);
+    hash_index_add(&symbol_index, hash, symbol_list.count - 1);
 
     return (symbol_list.count - 1);
 }
@@ -167,73 +242,267 @@ static void cdb_symbollist_add_all_to_banks() {
 }
 
 
+// === Per-shard symbol tables ===
+//
+// Each range of lines in the file (a shard) collects its symbols separately
+// so shards can be parsed in parallel (-j). They get merged into the main
+// symbol list afterward in file order, see cdb_shards_merge().
+
+// Which symbol fields a shard has set
+#define CDB_FIELD_START   0x01U
+#define CDB_FIELD_END     0x02U
+#define CDB_FIELD_LENGTH  0x04U
+
+// Files are split at line boundaries into shards of at least this size for parallel parsing (-j)
+#define CDB_SHARD_SIZE_MIN 0x10000U
+
+// Rough file bytes per symbol (each has several S:/L:/F: record lines), used to reserve shard symbol space
+#define CDB_BYTES_PER_SYMBOL_EST 128U
+
+typedef struct cdb_shard_symbol {
+    cdb_slice name;      // Full name in file data
+    uint32_t  start;
+    uint32_t  end;
+    uint32_t  length;
+    uint8_t   fields_set;
+} cdb_shard_symbol;
+
+typedef struct cdb_shard {
+    file_buffer_range file_range;
+    list_type         symbols;
+    hash_index        index;
+} cdb_shard;
+
+// Shard symbol lookup key for the hash index
+typedef struct cdb_shard_key {
+    cdb_slice         name;
+    const list_type * p_symbols;
+} cdb_shard_key;
+
+typedef struct cdb_parse_job {
+    const file_buffer * p_file;
+    cdb_shard *         shards;
+} cdb_parse_job;
+
+
+// Hash index match function: compare a name against a shard symbol name
+static bool shard_symbol_name_matches(uint32_t symbol_idx, const void * p_key) {
+
+    const cdb_shard_key * p_shard_key = (const cdb_shard_key *)p_key;
+    const cdb_slice * p_symbol_name = &(((cdb_shard_symbol *)p_shard_key->p_symbols->p_array)[symbol_idx].name);
+
+    return ((p_symbol_name->len == p_shard_key->name.len) &&
+            (memcmp(p_symbol_name->p_str, p_shard_key->name.p_str, p_shard_key->name.len) == 0));
+}
+
+
+// Find a matching symbol in a shard, if none matches a new one is added and returned
+//
+// Names only get interned when the shards are merged, since
+// interning isn't thread safe. See symbollist_get_id_by_name().
+static int shard_get_id_by_name(cdb_shard * p_shard, cdb_slice symbol_name) {
+
+    cdb_shard_symbol new_symbol;
+    cdb_shard_key    key;
+    uint32_t         hash;
+    int32_t          symbol_id;
+
+    key.name      = symbol_name;
+    key.p_symbols = &(p_shard->symbols);
+    hash = hash_index_hash_str(symbol_name.p_str, symbol_name.len);
+    symbol_id = hash_index_find(&(p_shard->index), hash, shard_symbol_name_matches, &key);
+    if (symbol_id != HASH_INDEX_NOT_FOUND)
+        return symbol_id;
+
+    new_symbol.name       = symbol_name;
+    new_symbol.start      = AREA_VAL_UNSET;
+    new_symbol.end        = AREA_VAL_UNSET;
+    new_symbol.length     = AREA_VAL_UNSET;
+    new_symbol.fields_set = 0;
+    list_additem(&(p_shard->symbols), &new_symbol);
+    hash_index_add(&(p_shard->index), hash, p_shard->symbols.count - 1);
+
+    return (p_shard->symbols.count - 1);
+}
+
+
 // Adds start/end address from a Linker Record
 // Requires either separate calls for Start and End, or one call for
 // start and a separate cdb_add_record_symbol() call to set length
-static void cdb_add_record_linker(char * type, char * name, char * address) {
-
-    area_item * symbols = (area_item *)symbol_list.p_array;
+static void cdb_add_record_linker(cdb_shard * p_shard, cdb_slice type, cdb_slice name, cdb_slice address) {
 
     // Retrieve existing symbol or create a new one
-    int symbol_id = symbollist_get_id_by_name(name);
+    int symbol_id = shard_get_id_by_name(p_shard, name);
 
     if (symbol_id != ERR_NO_AREAS_LEFT) {
 
+        cdb_shard_symbol * symbols = (cdb_shard_symbol *)p_shard->symbols.p_array;
+
         // Check Linker record for start-address or end-address
         // Bank number is in the address bits, no need to modify it
-        if ((strncmp(type, CDB_L_REC_FUNC_END_GLOBAL, 4) == 0) ||
-            (strncmp(type, CDB_L_REC_FUNC_END_LOCAL, 4) == 0)) {
-            symbols[symbol_id].end = strtol(address, NULL, 16);     // End address
+        if ((type.len == CDB_L_REC_FUNC_END_LEN) &&
+            ((memcmp(type.p_str, CDB_L_REC_FUNC_END_GLOBAL, CDB_L_REC_FUNC_END_LEN) == 0) ||
+             (memcmp(type.p_str, CDB_L_REC_FUNC_END_LOCAL, CDB_L_REC_FUNC_END_LEN) == 0))) {
+            symbols[symbol_id].end = cdb_slice_to_long(address, 16);     // End address
+            symbols[symbol_id].fields_set |= CDB_FIELD_END;
         }
-        else if ((type[0] == CDB_L_REC_FUNC_START_GLOBAL) ||
-                 (type[0] == CDB_L_REC_FUNC_START_LOCAL)) {
-            symbols[symbol_id].start = strtol(address, NULL, 16);   // Start address
+        else if ((type.p_str[0] == CDB_L_REC_FUNC_START_GLOBAL) ||
+                 (type.p_str[0] == CDB_L_REC_FUNC_START_LOCAL)) {
+            symbols[symbol_id].start = cdb_slice_to_long(address, 16);   // Start address
+            symbols[symbol_id].fields_set |= CDB_FIELD_START;
         }
         // else
-        // printf("Rejected L record %s, %s, %s\n", type, name, address);
+        // printf("Rejected L record %.*s, %.*s, %.*s\n", type.len, type.p_str, name.len, name.p_str, address.len, address.p_str);
     }
 }
 
 
 // Adds length from a symbol record
 // To get a complete entry requires a start address call to cdb_add_record_linker()
-static void cdb_add_record_symbol(char * addr_space, char * name, char * length, char * dcl_type) {
-
-    area_item * symbols = (area_item *)symbol_list.p_array;
+static void cdb_add_record_symbol(cdb_shard * p_shard, cdb_slice addr_space, cdb_slice name, cdb_slice length, cdb_slice dcl_type) {
 
     // Only allow certain address spaces
-    if ((addr_space[0] == 'C') || // Address Space: Code
-        (addr_space[0] == 'D') || // Address Space: Code / static segment
-        (addr_space[0] == 'E') || // Address Space: Internal RAM (lower 128) bytes
-        (addr_space[0] == 'F') || // Address Space: External RAM
-        (addr_space[0] == 'G')) { // Address Space: Internal RAM
+    if ((addr_space.p_str[0] == 'C') || // Address Space: Code
+        (addr_space.p_str[0] == 'D') || // Address Space: Code / static segment
+        (addr_space.p_str[0] == 'E') || // Address Space: Internal RAM (lower 128) bytes
+        (addr_space.p_str[0] == 'F') || // Address Space: External RAM
+        (addr_space.p_str[0] == 'G')) { // Address Space: Internal RAM
+
+        long length_value = cdb_slice_to_long(length, 10);
 
         // Exclude zero length entries
         // Don't let function ~entry points override function bodies(<DCLType> = DF, function which are two bytes in size)
-        if ((strtol(length, NULL, 10) > 0) &&
-            (!strstr(dcl_type, "DF")))
+        if ((length_value > 0) &&
+            (!cdb_slice_contains(dcl_type, "DF")))
         {
             // Retrieve existing symbol or create a new one
-            int symbol_id = symbollist_get_id_by_name(name); // [2] Area Name
+            int symbol_id = shard_get_id_by_name(p_shard, name); // [2] Area Name
             if (symbol_id != ERR_NO_AREAS_LEFT) {
-                    symbols[symbol_id].length = strtol(length, NULL, 10); // [5] Symbol decimal length
+                    cdb_shard_symbol * symbols = (cdb_shard_symbol *)p_shard->symbols.p_array;
+                    symbols[symbol_id].length = length_value; // [5] Symbol decimal length
+                    symbols[symbol_id].fields_set |= CDB_FIELD_LENGTH;
             }
         }
     }
     // else
-    // printf("Rejected S record %s, %s, %s, %s\n", addr_space, name, length, dcl_type);
+    // printf("Rejected S record %.*s, %.*s\n", addr_space.len, addr_space.p_str, name.len, name.p_str);
+}
+
+
+#define CDB_IS_SPLIT_CHAR(c) (((c) == ':') || ((c) == '$') || ((c) == '(') || ((c) == '{') || \
+                              ((c) == '}') || ((c) == ')') || ((c) == ','))
+
+// Split a record line into words separated by any of ":$({}),"
+// without modifying it. Works the same as repeated strtok() calls:
+// empty words are skipped and the line ends at the first '\0'.
+//
+// Stops after max_words, returns number of words found
+static uint32_t cdb_record_split(const char * p_line, uint32_t line_len, cdb_slice * p_words, uint32_t max_words) {
+
+    uint32_t count = 0;
+    uint32_t c = 0;
+
+    while ((c < line_len) && (p_line[c] != '\0') && (count < max_words)) {
+
+        // Skip separators
+        if (CDB_IS_SPLIT_CHAR(p_line[c])) {
+            c++;
+            continue;
+        }
+
+        // Word runs until next separator or end of line
+        p_words[count].p_str = &p_line[c];
+        while ((c < line_len) && (p_line[c] != '\0') && !CDB_IS_SPLIT_CHAR(p_line[c]))
+            c++;
+        p_words[count].len = (uint32_t)(&p_line[c] - p_words[count].p_str);
+        count++;
+    }
+
+    return count;
+}
+
+
+// Process a single line from a .cdb file
+static void cdb_process_record(cdb_shard * p_shard, const char * p_line, uint32_t line_len) {
+
+    cdb_slice words[CDB_MAX_SPLIT_WORDS];
+    uint32_t  cols;
+
+    // Only _S_egment or _L_ength records are used, reject anything else from the start of line
+    if ((line_len < CDB_REC_START_LEN) || (p_line[1] != ':') ||
+        ((p_line[0] != CDB_REC_L) && (p_line[0] != CDB_REC_S)))
+        return;
+
+    cols = cdb_record_split(p_line, line_len, words, CDB_MAX_SPLIT_WORDS);
+
+    // Linker record (start or end address)
+    if ((p_line[0] == CDB_REC_L) &&
+        (cols == CDB_REC_L_COUNT_MATCH)) {
+        // [1] Start/End, [2] Area Name1, [5] Address
+        cdb_add_record_linker(p_shard, words[1], words[2], words[5]);
+    }
+    // Symbol record (length)
+    else if ((p_line[0] == CDB_REC_S) &&
+             (cols == CDB_REC_S_COUNT_MATCH)) {
+        // [9] address space, [2] Area Name, [5] Symbol decimal length, [6] DCLType
+        cdb_add_record_symbol(p_shard, words[9], words[2], words[5], words[6]);
+    }
+}
+
+
+// Parse all records in a shard, may be called from a worker thread
+static void cdb_shard_parse(uint32_t shard_idx, void * p_ctx) {
+
+    cdb_parse_job * p_job   = (cdb_parse_job *)p_ctx;
+    cdb_shard *     p_shard = &(p_job->shards[shard_idx]);
+    uint32_t        file_pos = p_shard->file_range.start;
+    const char *    p_line;
+    uint32_t        line_len;
+
+    list_init(&(p_shard->symbols), sizeof(cdb_shard_symbol));
+    list_reserve(&(p_shard->symbols), (p_shard->file_range.end - p_shard->file_range.start) / CDB_BYTES_PER_SYMBOL_EST);
+    hash_index_init(&(p_shard->index));
+
+    while ((file_pos < p_shard->file_range.end) &&
+           file_buffer_next_line(p_job->p_file, &file_pos, &p_line, &line_len, CDB_MAX_STR_LEN - 1)) {
+        cdb_process_record(p_shard, p_line, line_len);
+    }
+}
+
+
+// Merge shard symbols into the main symbol list in file order
+//
+// Symbols get added in order of first appearance, and for each field
+// the value from the last record that set it wins, same as parsing
+// the whole file in one pass.
+static void cdb_shards_merge(cdb_shard * shards, uint32_t shard_count) {
+
+    for (uint32_t c = 0; c < shard_count; c++) {
+
+        cdb_shard_symbol * shard_symbols = (cdb_shard_symbol *)shards[c].symbols.p_array;
+
+        for (uint32_t s = 0; s < shards[c].symbols.count; s++) {
+
+            int symbol_id = symbollist_get_id_by_name(shard_symbols[s].name);
+            area_item * symbols = (area_item *)symbol_list.p_array;
+
+            if (shard_symbols[s].fields_set & CDB_FIELD_START)  symbols[symbol_id].start  = shard_symbols[s].start;
+            if (shard_symbols[s].fields_set & CDB_FIELD_END)    symbols[symbol_id].end    = shard_symbols[s].end;
+            if (shard_symbols[s].fields_set & CDB_FIELD_LENGTH) symbols[symbol_id].length = shard_symbols[s].length;
+        }
+
+        list_cleanup(&(shards[c].symbols));
+        hash_index_cleanup(&(shards[c].index));
+    }
 }
 
 
 int cdb_file_process_symbols(char * filename_in) {
 
-    int cols;
-    char * p_str;
-    char * p_words[CDB_MAX_SPLIT_WORDS];
-    char strline_in[CDB_MAX_STR_LEN] = "";
-    FILE * cdb_file = fopen(filename_in, "r");
-    area_item symbol;
-    int symbol_id;
+    file_buffer         cdb_file;
+    file_buffer_range * file_ranges;
+    cdb_parse_job       job;
+    uint32_t            shard_count;
 
     // CDB defaults to showing areas
     banks_output_show_areas(true);
@@ -244,55 +513,32 @@ int cdb_file_process_symbols(char * filename_in) {
 
     set_option_input_source(OPT_INPUT_SRC_CDB);
 
-    if (cdb_file) {
-
-        // Read one line at a time into \0 terminated string
-        while ( fgets(strline_in, sizeof(strline_in), cdb_file) != NULL) {
-
-            // Require minimum length to match
-            if (strlen(strline_in) >= CDB_REC_START_LEN) {
-
-                // Match either _S_egment or _L_ength records
-                if ( (strncmp(strline_in, "L:", CDB_REC_START_LEN) == 0) ||
-                     (strncmp(strline_in, "S:", CDB_REC_START_LEN) == 0)) {
-
-                    // Split string into words separated by spaces
-                    cols = 0;
-                    p_str = strtok(strline_in,":$({}),");
-                    while (p_str != NULL)
-                    {
-                        p_words[cols++] = p_str;
-                        p_str = strtok(NULL, ":$({}),");
-                        if (cols >= CDB_MAX_SPLIT_WORDS) break;
-                    }
-
-                    // Linker record (start or end address)
-                    if ((p_words[0][0] == CDB_REC_L) &&
-                        (cols == CDB_REC_L_COUNT_MATCH)) {
-                        // [1] Start/End, [2] Area Name1, [5] Address
-                        cdb_add_record_linker(p_words[1], p_words[2], p_words[5]);
-                    }
-                    // Symbol record (length)
-                    if ((p_words[0][0] == CDB_REC_S) &&
-                        (cols == CDB_REC_S_COUNT_MATCH)) {
-                        // [9] address space, [2] Area Name, [5] Symbol decimal length, [6] DCLType
-                        cdb_add_record_symbol(p_words[9], p_words[2], p_words[5], p_words[6]);
-                    }
-
-                } // end: if valid start of line
-            } // end: valid min chars to process line
-        } // end: while still lines to process
-
-        fclose(cdb_file);
-
-        // Process all the symbols
-        cdb_symbollist_add_all_to_banks();
-
-    } // end: if valid file
-    else {
-        log_error("Error: Failed to open input file %s\n", filename_in);
+    // Map (or read) in the whole file
+    if (!file_buffer_load(&cdb_file, filename_in)) {
+        // Error message already logged when loading failed
         return false;
     }
 
+    // Parse shards of the file (in parallel with -j), then merge them
+    job.p_file  = &cdb_file;
+    shard_count = file_buffer_split_lines(&cdb_file, parallel_get_chunk_count(), CDB_SHARD_SIZE_MIN, &file_ranges);
+    job.shards  = (cdb_shard *)calloc(shard_count, sizeof(cdb_shard));
+    if (!job.shards) {
+        log_error("Error: Failed to allocate memory for CDB shards!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t c = 0; c < shard_count; c++)
+        job.shards[c].file_range = file_ranges[c];
+    free(file_ranges);
+
+    parallel_for(shard_count, cdb_shard_parse, &job);
+    cdb_shards_merge(job.shards, shard_count);
+
+    free(job.shards);
+    file_buffer_release(&cdb_file);
+
+    // Process all the symbols
+    cdb_symbollist_add_all_to_banks();
+
    return true;
 }
@@ -7,6 +7,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <unistd.h>
 
 #include "common.h"
 #include "logging.h"
@@ -31,6 +32,7 @@ bool option_display_asciistyle;
 bool option_all_areas_exclusive;
 bool option_quiet_mode;
 bool option_suppress_duplicates;
+bool option_duplicates_substring;
 bool option_error_on_warning;
 bool option_hide_banners;
 int  option_input_source;
@@ -39,6 +41,8 @@ int  option_color_mode;
 bool option_percentage_based_color;
 uint32_t option_area_hide_size;
 bool option_is_web_mode;
+unsigned int option_thread_count;
+uint32_t option_largegraph_bytes_per_char;
 
 bool exit_error;
 
@@ -68,6 +72,7 @@ void options_reset_all(void) {
     option_all_areas_exclusive = false;
     option_quiet_mode          = false;
     option_suppress_duplicates = true;
+    option_duplicates_substring = false;
     option_error_on_warning    = false;
     option_hide_banners        = false;
     option_input_source        = OPT_INPUT_SRC_NONE;
@@ -76,6 +81,8 @@ void options_reset_all(void) {
     option_percentage_based_color = false;
     option_area_hide_size      = OPT_AREA_HIDE_SIZE_DEFAULT;
     option_is_web_mode         = true;
+    option_thread_count        = OPT_THREAD_COUNT_DEFAULT;
+    option_largegraph_bytes_per_char = OPT_LARGEGRAPH_BYTES_PER_CHAR_DEFAULT;
 
     exit_error                 = false;
 
@@ -150,6 +157,12 @@ void set_option_suppress_duplicates(bool value) {
     option_suppress_duplicates = value;
 }
 
+// Turn on/off legacy duplicate matching, where an area is a duplicate
+// if its name contains the name of an existing area with the same range
+void set_option_duplicates_substring(bool value) {
+    option_duplicates_substring = value;
+}
+
 // Turn on/off setting an error on exit for serious warnings encountered
 void set_option_error_on_warning(bool value) {
     option_error_on_warning = value;
@@ -265,6 +278,15 @@ bool get_option_display_asciistyle(void) {
     return option_display_asciistyle;
 }
 
+// Number of threads to use for processing
+unsigned int get_option_thread_count(void) {
+    return option_thread_count;
+}
+
+uint32_t get_option_largegraph_bytes_per_char(void) {
+    return option_largegraph_bytes_per_char;
+}
+
 
 // Add a substring for hiding banks
 bool set_option_banks_hide_add(char * str_bank_hide_substring) {
@@ -316,6 +338,58 @@ bool set_option_binary_rom_empty_values(char * arg_str) {
 }
 
 
+// Set number of threads used for processing -j or -j:DECCOUNT
+//       -j   : one thread per available CPU
+//       -j:4 : four threads
+// Value passed in has "-j" stripped off the front
+bool set_option_thread_count(char * arg_str) {
+
+    long thread_count = 0;
+
+    if (arg_str[0] == '\0') {
+        // Auto detect CPU count where possible
+        #if defined(_SC_NPROCESSORS_ONLN)
+            thread_count = sysconf(_SC_NPROCESSORS_ONLN);
+        #endif
+        if (thread_count < 1) thread_count = OPT_THREAD_COUNT_DEFAULT;
+    }
+    else if (arg_str[0] == ':') {
+        char * p_end;
+        thread_count = strtol(arg_str + 1, &p_end, 10);
+        if ((p_end == arg_str + 1) || (*p_end != '\0') || (thread_count < 1))
+            return false; // Signal failure
+    }
+    else
+        return false; // Signal failure
+
+    if (thread_count > OPT_THREAD_COUNT_MAX) thread_count = OPT_THREAD_COUNT_MAX;
+    option_thread_count = (unsigned int)thread_count;
+    return true;
+}
+
+
+// Set bytes per character for the large graph -G or -G:DECBYTES
+//       -G    : default (16 bytes per character)
+//       -G:64 : 64 bytes per character
+// Value passed in has "-G" (and "A" for ascii style) stripped off the front
+bool set_option_largegraph_bytes_per_char(char * arg_str) {
+
+    if (arg_str[0] == '\0')
+        return true; // Keep current setting
+    else if (arg_str[0] == ':') {
+        char * p_end;
+        long bytes_per_char = strtol(arg_str + 1, &p_end, 10);
+        if ((p_end == arg_str + 1) || (*p_end != '\0') || (bytes_per_char < 1))
+            return false; // Signal failure
+
+        option_largegraph_bytes_per_char = (uint32_t)bytes_per_char;
+        return true;
+    }
+    else
+        return false; // Signal failure
+}
+
+
 void set_exit_error(void) {
     exit_error = true;
 }
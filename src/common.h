@@ -39,6 +39,11 @@
 #define OPT_PLAT_SMS_GG_GBDK 1u  // GBDK specific layout for SMS/GG
 #define OPT_PLAT_NES_GBDK_1  2u  // GBDK specific layout for NES
 
+#define OPT_THREAD_COUNT_DEFAULT 1  // Single threaded unless -j is used
+#define OPT_THREAD_COUNT_MAX     64
+
+#define OPT_LARGEGRAPH_BYTES_PER_CHAR_DEFAULT 16
+
 #define BANKS_HIDE_SZ 30  // How many hide substrings to support
 #define BANKS_HIDE_MAX (BANKS_HIDE_SZ - 1)
 
@@ -59,6 +64,7 @@ extern unsigned int option_forced_display_max_bank_SRAM;
 extern bool option_all_areas_exclusive;
 extern bool option_quiet_mode;
 extern bool option_suppress_duplicates;
+extern bool option_duplicates_substring;
 extern bool option_error_on_warning;
 extern unsigned int option_merged_banks;
 // Use get_/set_() for these
@@ -76,6 +82,7 @@ extern char banks_hide_list[BANKS_HIDE_SZ][DEFAULT_STR_LEN];
 void set_option_all_areas_exclusive(bool value);
 void set_option_quiet_mode(bool value);
 void set_option_suppress_duplicates(bool value);
+void set_option_duplicates_substring(bool value);
 void set_option_error_on_warning(bool value);
 void set_option_hide_banners(bool value);
 void set_option_input_source(int value);
@@ -94,6 +101,8 @@ bool set_option_displayed_bank_range(char * arg_str);
 void set_option_merged_banks(unsigned int value);
 bool set_option_banks_hide_add(char * str_bank_hide_substring);
 bool set_option_binary_rom_empty_values(char * arg_str);
+bool set_option_thread_count(char * arg_str);
+bool set_option_largegraph_bytes_per_char(char * arg_str);
 
 int  get_option_input_source(void);
 int  get_option_area_sort(void);
@@ -103,6 +112,8 @@ bool get_option_hide_banners(void);
 unsigned int get_option_platform(void);
 bool get_option_display_asciistyle(void);
 uint32_t get_option_area_hide_size(void);
+unsigned int get_option_thread_count(void);
+uint32_t get_option_largegraph_bytes_per_char(void);
 
 uint32_t round_up_power_of_2(uint32_t val);
 
@@ -0,0 +1,197 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "logging.h"
+#include "file_buffer.h"
+
+// Memory mapping is only used on POSIX platforms. Windows and
+// the web build (emscripten virtual filesystem) always read
+// the file into an allocated buffer instead.
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+    #define FILE_BUFFER_MMAP_ENABLED
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+
+// Read from a file into a buffer (will allocate needed memory)
+// Returns NULL if reading file didn't succeed
+uint8_t * file_read_into_buffer(char * filename, uint32_t *ret_size) {
+
+    long fsize;
+    FILE * file_in = fopen(filename, "rb");
+    uint8_t * filedata = NULL;
+
+    if (file_in) {
+        // Get file size
+        fseek(file_in, 0, SEEK_END);
+        fsize = ftell(file_in);
+        if (fsize != -1L) {
+            fseek(file_in, 0, SEEK_SET);
+
+            filedata = (uint8_t *)malloc(fsize);
+            if (filedata) {
+                if (fsize != fread(filedata, 1, fsize, file_in)) {
+                    log_warning("Warning: File read size didn't match expected for %s\n", filename);
+                    filedata = NULL;
+                }
+                // Read was successful, set return size
+                *ret_size = fsize;
+            } else log_error("Error: Failed to allocate memory to read file %s\n", filename);
+
+        } else log_error("Error: Failed to read size of file %s\n", filename);
+
+        fclose(file_in);
+    } else log_error("Error: Failed to open input file %s\n", filename);
+
+    return filedata;
+}
+
+
+#ifdef FILE_BUFFER_MMAP_ENABLED
+// Try to map a file directly into memory (read-only, no copy)
+// Returns false for anything that can't be mapped (pipes, empty files, etc)
+// so the caller can fall back to reading it into a buffer
+static bool file_buffer_try_map(file_buffer * p_file, char * filename) {
+
+    struct stat file_stat;
+    void * p_map;
+    int fd = open(filename, O_RDONLY);
+
+    if (fd == -1) return false;
+
+    if ((fstat(fd, &file_stat) == 0) &&
+        S_ISREG(file_stat.st_mode) &&
+        (file_stat.st_size > 0) && (file_stat.st_size <= UINT32_MAX)) {
+
+        p_map = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p_map != MAP_FAILED) {
+            // Input files are scanned start to finish, so let the kernel read ahead aggressively
+            madvise(p_map, file_stat.st_size, MADV_SEQUENTIAL);
+
+            p_file->p_data    = (const uint8_t *)p_map;
+            p_file->size      = (uint32_t)file_stat.st_size;
+            p_file->is_mapped = true;
+        }
+    }
+
+    // The mapping (if any) remains valid after the descriptor is closed
+    close(fd);
+    return p_file->is_mapped;
+}
+#endif
+
+
+// Load an entire file into memory for reading.
+// Uses a memory map when possible, otherwise reads it into an allocated buffer.
+//
+// Returns false if loading the file didn't succeed.
+// Must be followed by a call to file_buffer_release() when done with the data.
+bool file_buffer_load(file_buffer * p_file, char * filename) {
+
+    p_file->p_data    = NULL;
+    p_file->size      = 0;
+    p_file->is_mapped = false;
+
+    #ifdef FILE_BUFFER_MMAP_ENABLED
+        if (file_buffer_try_map(p_file, filename))
+            return true;
+    #endif
+
+    // Fall back to a buffered read
+    p_file->p_data = file_read_into_buffer(filename, &p_file->size);
+    return (p_file->p_data != NULL);
+}
+
+
+// Unmap or free the file data
+void file_buffer_release(file_buffer * p_file) {
+
+    if (p_file->p_data) {
+        #ifdef FILE_BUFFER_MMAP_ENABLED
+            if (p_file->is_mapped)
+                munmap((void *)p_file->p_data, p_file->size);
+            else
+                free((void *)p_file->p_data);
+        #else
+            free((void *)p_file->p_data);
+        #endif
+        p_file->p_data = NULL;
+    }
+    p_file->size      = 0;
+    p_file->is_mapped = false;
+}
+
+
+// Get the next line from a loaded file, starting at *p_pos (which gets advanced past it)
+//
+// Works like fgets() with a buffer of (max_len + 1): the line includes
+// the trailing newline if present, and longer lines are returned in
+// max_len sized pieces. The line is not '\0' terminated, use *p_line_len.
+//
+// Returns false when there are no more lines
+bool file_buffer_next_line(const file_buffer * p_file, uint32_t * p_pos, const char ** pp_line, uint32_t * p_line_len, uint32_t max_len) {
+
+    uint32_t pos = *p_pos;
+    uint32_t search_len;
+    const uint8_t * p_newline;
+
+    if (pos >= p_file->size) return false;
+
+    search_len = min(p_file->size - pos, max_len);
+    p_newline = (const uint8_t *)memchr(p_file->p_data + pos, '\n', search_len);
+
+    *pp_line    = (const char *)(p_file->p_data + pos);
+    *p_line_len = (p_newline) ? (uint32_t)(p_newline - (p_file->p_data + pos)) + 1 : search_len;
+    *p_pos      = pos + *p_line_len;
+    return true;
+}
+
+
+// Split a loaded file into roughly equal sized ranges that start and end
+// on line boundaries, for processing different parts of a file separately
+//
+// Makes at most max_ranges, each at least min_range_size (except with a small file)
+// Allocates *pp_ranges which must be freed by the caller. Returns number of ranges (always >= 1)
+uint32_t file_buffer_split_lines(const file_buffer * p_file, uint32_t max_ranges, uint32_t min_range_size, file_buffer_range ** pp_ranges) {
+
+    uint32_t range_count = max(1, min(max_ranges, p_file->size / max(min_range_size, 1)));
+    uint32_t range_size  = p_file->size / range_count;
+    uint32_t file_pos = 0;
+    uint32_t c;
+
+    *pp_ranges = (file_buffer_range *)calloc(range_count, sizeof(file_buffer_range));
+    if (!*pp_ranges) {
+        log_error("Error: Failed to allocate memory for file ranges!\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (c = 0; (c < range_count) && (file_pos < p_file->size); c++) {
+
+        (*pp_ranges)[c].start = file_pos;
+
+        // Move range end forward to the start of the next line
+        if (c == (range_count - 1)) {
+            file_pos = p_file->size;
+        } else {
+            const uint8_t * p_newline;
+            file_pos = max(file_pos, (c + 1) * range_size);
+            p_newline = (const uint8_t *)memchr(p_file->p_data + file_pos, '\n', p_file->size - file_pos);
+            file_pos = (p_newline) ? (uint32_t)(p_newline - p_file->p_data) + 1 : p_file->size;
+        }
+        (*pp_ranges)[c].end = file_pos;
+    }
+
+    // There may be fewer ranges than planned if lines were long
+    return max(c, 1);
+}
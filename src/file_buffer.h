@@ -0,0 +1,31 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#ifndef _FILE_BUFFER_H
+#define _FILE_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Whole input file loaded into memory, either mapped or read into an allocated copy
+typedef struct file_buffer {
+    const uint8_t * p_data;
+    uint32_t        size;
+    bool            is_mapped; // true if p_data is a (read-only) memory map of the file
+} file_buffer;
+
+// A range of a loaded file [start, end)
+typedef struct file_buffer_range {
+    uint32_t start;
+    uint32_t end;
+} file_buffer_range;
+
+uint8_t * file_read_into_buffer(char * filename, uint32_t *ret_size);
+
+bool file_buffer_load(file_buffer * p_file, char * filename);
+void file_buffer_release(file_buffer * p_file);
+uint32_t file_buffer_split_lines(const file_buffer * p_file, uint32_t max_ranges, uint32_t min_range_size, file_buffer_range ** pp_ranges);
+bool file_buffer_next_line(const file_buffer * p_file, uint32_t * p_pos, const char ** pp_line, uint32_t * p_line_len, uint32_t max_len);
+
+#endif // _FILE_BUFFER_H
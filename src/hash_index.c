@@ -0,0 +1,138 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "logging.h"
+#include "hash_index.h"
+
+#define HASH_INDEX_SIZE_INITIAL 256 // Must be a power of 2
+
+#define FNV1A_OFFSET_BASIS 0x811C9DC5U
+#define FNV1A_PRIME        0x01000193U
+
+
+// 32 bit FNV-1a hash of a string with known length
+uint32_t hash_index_hash_str(const char * p_str, size_t len) {
+
+    uint32_t hash = FNV1A_OFFSET_BASIS;
+
+    while (len--) {
+        hash ^= (uint8_t)*p_str++;
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+
+// Hash of a 32 bit value (such as an ID) for use with the index
+uint32_t hash_index_hash_u32(uint32_t value) {
+
+    // Murmur3 finalizer, spreads bits so low slot bits vary
+    value ^= value >> 16;
+    value *= 0x85EBCA6BU;
+    value ^= value >> 13;
+    value *= 0xC2B2AE35U;
+    value ^= value >> 16;
+    return value;
+}
+
+
+static void hash_index_alloc_slots(hash_index * p_index, uint32_t size) {
+
+    p_index->size    = size;
+    p_index->count   = 0;
+    p_index->p_slots = (hash_index_slot *)calloc(size, sizeof(hash_index_slot));
+
+    if (!p_index->p_slots) {
+        log_error("Error: Failed to allocate memory for hash index!\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+// Insert without checking for duplicates or growing
+static void hash_index_insert(hash_index * p_index, uint32_t hash, uint32_t item_idx_plus_one) {
+
+    uint32_t mask = p_index->size - 1;
+    uint32_t slot = hash & mask;
+
+    // Linear probing
+    while (p_index->p_slots[slot].item_idx_plus_one != 0)
+        slot = (slot + 1) & mask;
+
+    p_index->p_slots[slot].hash = hash;
+    p_index->p_slots[slot].item_idx_plus_one = item_idx_plus_one;
+    p_index->count++;
+}
+
+
+// Double the number of slots and re-insert existing entries
+static void hash_index_grow(hash_index * p_index) {
+
+    hash_index_slot * p_old_slots = p_index->p_slots;
+    uint32_t          old_size    = p_index->size;
+
+    hash_index_alloc_slots(p_index, (old_size) ? (old_size * 2) : HASH_INDEX_SIZE_INITIAL);
+
+    for (uint32_t c = 0; c < old_size; c++) {
+        if (p_old_slots[c].item_idx_plus_one != 0)
+            hash_index_insert(p_index, p_old_slots[c].hash, p_old_slots[c].item_idx_plus_one);
+    }
+    free(p_old_slots);
+}
+
+
+void hash_index_init(hash_index * p_index) {
+
+    hash_index_alloc_slots(p_index, HASH_INDEX_SIZE_INITIAL);
+}
+
+
+// Also leaves the index empty and usable, slots get allocated again on the next add
+void hash_index_cleanup(hash_index * p_index) {
+
+    if (p_index->p_slots) {
+        free(p_index->p_slots);
+        p_index->p_slots = NULL;
+    }
+    p_index->size  = 0;
+    p_index->count = 0;
+}
+
+
+// Find the first indexed item with a matching hash that p_match_fn accepts for p_key
+// Returns the item index, or HASH_INDEX_NOT_FOUND
+int32_t hash_index_find(const hash_index * p_index, uint32_t hash, hash_index_match_fn p_match_fn, const void * p_key) {
+
+    if (p_index->size == 0)
+        return HASH_INDEX_NOT_FOUND;
+
+    uint32_t mask = p_index->size - 1;
+    uint32_t slot = hash & mask;
+
+    while (p_index->p_slots[slot].item_idx_plus_one != 0) {
+        if ((p_index->p_slots[slot].hash == hash) &&
+            p_match_fn(p_index->p_slots[slot].item_idx_plus_one - 1, p_key))
+            return (int32_t)(p_index->p_slots[slot].item_idx_plus_one - 1);
+
+        slot = (slot + 1) & mask;
+    }
+    return HASH_INDEX_NOT_FOUND;
+}
+
+
+// Add an item index to the index (caller should check it's not already present)
+void hash_index_add(hash_index * p_index, uint32_t hash, uint32_t item_idx) {
+
+    // Keep load at or under 50%
+    if ((p_index->count + 1) * 2 > p_index->size)
+        hash_index_grow(p_index);
+
+    hash_index_insert(p_index, hash, item_idx + 1);
+}
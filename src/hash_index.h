@@ -0,0 +1,36 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#ifndef _HASH_INDEX_H
+#define _HASH_INDEX_H
+
+// Open addressing hash index over items stored elsewhere (usually a list_type).
+// Only item indexes and their hashes are kept in the index, the caller
+// provides a match function to compare a key against an item.
+
+#define HASH_INDEX_NOT_FOUND -1
+
+typedef struct hash_index_slot {
+    uint32_t hash;
+    uint32_t item_idx_plus_one; // 0 = empty slot
+} hash_index_slot;
+
+typedef struct hash_index {
+    hash_index_slot * p_slots;
+    uint32_t          size;  // Always a power of 2
+    uint32_t          count;
+} hash_index;
+
+// Returns true if p_key matches the item at item_idx
+typedef bool (*hash_index_match_fn)(uint32_t item_idx, const void * p_key);
+
+uint32_t hash_index_hash_str(const char * p_str, size_t len);
+uint32_t hash_index_hash_u32(uint32_t value);
+
+void hash_index_init(hash_index * p_index);
+void hash_index_cleanup(hash_index * p_index);
+int32_t hash_index_find(const hash_index * p_index, uint32_t hash, hash_index_match_fn p_match_fn, const void * p_key);
+void hash_index_add(hash_index * p_index, uint32_t hash, uint32_t item_idx);
+
+#endif // _HASH_INDEX_H
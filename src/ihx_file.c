@@ -11,7 +11,11 @@
 
 #include "common.h"
 #include "logging.h"
+#include "list.h"
 #include "banks.h"
+#include "str_intern.h"
+#include "file_buffer.h"
+#include "parallel.h"
 #include "ihx_file.h"
 
 // Example data to parse from a .ihx file
@@ -61,16 +65,50 @@ Currently the 100% bank will get merged into the next one and present as overflo
 #define IHX_REC_EXTLIN   0x04U
 #define IHX_REC_STARTLIN 0x05U
 
+// Parse results, checked in order when records are processed
+#define IHX_PARSE_OK            0U
+#define IHX_PARSE_BAD_START     1U
+#define IHX_PARSE_TOO_SHORT     2U
+#define IHX_PARSE_NOT_HEX       3U
+#define IHX_PARSE_BAD_LENGTH    4U
+#define IHX_PARSE_ZERO_LENGTH   5U
+#define IHX_PARSE_BAD_CHECKSUM  6U
+
+// Records that got far enough in parsing to have their address values set
+#define IHX_PARSE_HAS_ADDRESS(status) (((status) == IHX_PARSE_OK) || ((status) == IHX_PARSE_BAD_CHECKSUM))
+
+// Files are split at line boundaries into chunks of at least this size for parallel parsing (-j)
+#define IHX_CHUNK_SIZE_MIN      0x10000U
+
+// Typical record line length (16 data bytes, CRLF), used to estimate how many records a chunk holds
+#define IHX_REC_LINE_LEN_TYPICAL (IHX_REC_LEN_MIN + (16 * 2) + 2)
+
 typedef struct ihx_record {
-    uint16_t length;
+    const char * p_line;  // Record text in file data (not '\0' terminated)
+    uint16_t length;      // Record text length, excluding CR/LF
+    uint8_t  status;
     uint32_t byte_count;
     uint32_t address;
     uint32_t address_end;
     uint32_t type;
-    uint32_t checksum; // Would prefer this be a uint8_t, but mingw sscanf("%2hhx") has a buffer overflow that corrupts adjacent data
+    uint32_t checksum;
+    uint32_t checksum_calc;
+    uint32_t address_upper; // Extended linear address set by IHX_REC_EXTLIN records
 } ihx_record;
 
-uint32_t g_address_upper;
+// A range of lines in the file and the records parsed from them
+typedef struct ihx_chunk {
+    file_buffer_range file_range;
+    list_type records;
+    bool      sets_address_upper; // Whether any record in the chunk changes the extended linear address
+    uint32_t  address_upper_last; // Active extended linear address at end of chunk (if set in chunk)
+    uint32_t  address_upper_start; // Active extended linear address at start of chunk
+} ihx_chunk;
+
+typedef struct ihx_parse_job {
+    const file_buffer * p_file;
+    ihx_chunk *         chunks;
+} ihx_parse_job;
 
 // Converts sequentally stored ihx bank style (ROM0=0x0000, ROM1=0x4000, ROM2=0x8000)
 // into map/noi banked style (ROM0=0x0000, ROM1=0x04000, ROM2=0x14000)
@@ -84,120 +122,235 @@ uint32_t ihx_bank_2_mapnoi_bank(uint32_t addr) {
 }
 
 
-// Return false if any character isn't a valid hex digit
-int check_hex(char * c) {
-    while (*c != '\0') {
-        if ((*c >= '0') && (*c <= '9'))
-            c++;
-        if ((*c >= 'A') && (*c <= 'F'))
-            c++;
-        if ((*c >= 'a') && (*c <= 'f'))
-            c++;
-        else
-            return false;
+// Hex digit value lookup, invalid characters have IHX_HEX_INVALID set
+#define IHX_HEX_INVALID 0x10U
+#define XX IHX_HEX_INVALID
+static const uint8_t hex_nibble_lut[256] = {
+    XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,  XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX, // 0x00
+    XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,   0, 1, 2, 3, 4, 5, 6, 7, 8, 9,XX,XX,XX,XX,XX,XX, // 0x20 '0'-'9'
+    XX,10,11,12,13,14,15,XX,XX,XX,XX,XX,XX,XX,XX,XX,  XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX, // 0x40 'A'-'F'
+    XX,10,11,12,13,14,15,XX,XX,XX,XX,XX,XX,XX,XX,XX,  XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX, // 0x60 'a'-'f'
+    XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,  XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX, // 0x80
+    XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,  XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,
+    XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,  XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,
+    XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,  XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,XX,
+};
+#undef XX
+
+
+// Decode a string of hex digit pairs into bytes, validating all characters
+// and summing the decoded bytes along the way (single pass)
+//
+// An odd trailing character is validated but not decoded.
+// Returns false if any character isn't a valid hex digit
+static bool ihx_decode_hex(const char * p_str, uint32_t str_len, uint8_t * p_bytes, uint32_t * p_sum) {
+
+    uint32_t invalid = 0;
+    uint32_t sum = 0;
+    uint32_t c;
+
+    for (c = 0; (c + 1) < str_len; c += 2) {
+        uint32_t hi = hex_nibble_lut[(uint8_t)p_str[c]];
+        uint32_t lo = hex_nibble_lut[(uint8_t)p_str[c + 1]];
+        uint8_t  value = (uint8_t)((hi << 4) | (lo & 0x0FU));
+
+        invalid |= hi | lo;
+        *p_bytes++ = value;
+        sum += value;
     }
+    if (c < str_len) invalid |= hex_nibble_lut[(uint8_t)p_str[c]];
 
-    return true;
+    *p_sum = sum;
+    return ((invalid & IHX_HEX_INVALID) == 0);
 }
 
 
-// Parse and validate an IHX record
-int ihx_parse_and_validate_record(char * p_str, ihx_record * p_rec) {
-
-        int calc_length = 0;
-        int c;
-        uint32_t ctemp, checksum_calc = 0; // Avoid mingw sscanf("%2hhx") buffer overflow with uint8_t
-
-        // Remove trailing CR and LF
-        p_rec->length = strlen(p_str);
-        for (c = 0;c < p_rec->length;c++) {
-            if (p_str[c] == '\n' || p_str[c] == '\r') {
-                p_str[c] = '\0';   // Replace char with string terminator
-                p_rec->length = c; // Shrink length to truncated size
+// Parse and validate an IHX record in place from a line of p_line_len chars
+//
+// Doesn't log or depend on any state from previous records, so it's safe to
+// call from worker threads. The result is stored in p_rec->status and any
+// warnings get logged later in file order by ihx_record_log_warnings().
+//
+// Extended linear addresses are not applied here, see ihx_chunk_resolve_addresses()
+static void ihx_parse_and_validate_record(const char * p_line, uint32_t line_len, ihx_record * p_rec) {
+
+        uint32_t calc_length = 0;
+        uint32_t c;
+        uint32_t byte_sum;
+        uint8_t  rec_bytes[MAX_STR_LEN / 2];
+        uint8_t  * p_data;
+
+        p_rec->p_line = p_line;
+
+        // Record ends at first trailing CR or LF (or end of line)
+        p_rec->length = line_len;
+        for (c = 0;c < line_len;c++) {
+            if (p_line[c] == '\n' || p_line[c] == '\r' || p_line[c] == '\0') {
+                p_rec->length = c; // Shrink length to record size
                 break;             // Exit loop after finding first CR or LF
             }
         }
 
         // Only parse lines that start with ':' character (Start token for IHX record)
-        if (p_str[0] != ':') {
-            log_warning("Warning: IHX: Invalid start of line token for line: %s \n", p_str);
-            return false;
+        if ((p_rec->length == 0) || (p_line[0] != ':')) {
+            p_rec->status = IHX_PARSE_BAD_START;
+            return;
         }
 
        // Require minimum length
         if (p_rec->length < IHX_REC_LEN_MIN) {
-            log_warning("Warning: IHX: Invalid line, too few characters: %s. Is %d, needs at least %d \n", p_str, p_rec->length, IHX_REC_LEN_MIN);
-            return false;
+            p_rec->status = IHX_PARSE_TOO_SHORT;
+            return;
         }
 
-        // Only hex characters are allowed after start token
-        p_str++; // Advance past Start code
-        if (check_hex(p_str)) {
-            log_warning("Warning: IHX: Invalid line, non-hex characters present: %s\n", p_str);
-            return false;
+        // Only hex characters are allowed after start token.
+        // Decode the whole record to bytes in the same pass: byte count, address, type, data, checksum
+        if (!ihx_decode_hex(p_line + 1, p_rec->length - 1, rec_bytes, &byte_sum)) {
+            p_rec->status = IHX_PARSE_NOT_HEX;
+            return;
         }
 
         // Read record header: byte count, start address, type
-        sscanf(p_str, "%2x%4x%2x", &p_rec->byte_count, &p_rec->address, &p_rec->type);
-        p_str += (2 + 4 + 2);
+        p_rec->byte_count = rec_bytes[0];
+        p_rec->address    = ((uint32_t)rec_bytes[1] << 8) | rec_bytes[2];
+        p_rec->type       = rec_bytes[3];
+        p_data = &rec_bytes[4];
 
         // Require expected data byte count to fit within record length (at 2 chars per hex byte)
         calc_length = IHX_REC_LEN_MIN + (p_rec->byte_count * 2);
         if (p_rec->length != calc_length) {
-            log_warning("Warning: IHX: byte count doesn't match length available in record! Record length = %d, Calc length = %d, bytecount = %d \n", p_rec->length, calc_length, p_rec->byte_count);
-            return false;
+            p_rec->status = IHX_PARSE_BAD_LENGTH;
+            return;
         }
 
         // Is this an extended linear address record? Read in offset address if so
+        // (first 4 hex chars after the header, only the checksum is present if there is no data)
         if (p_rec->type == IHX_REC_EXTLIN) {
-            sscanf(p_str, "%4x", &g_address_upper);
-            g_address_upper <<= 16; // Shift into upper 16 bits of address space
+            if (p_rec->byte_count == 0) p_rec->address_upper = p_data[0];
+            else                        p_rec->address_upper = ((uint32_t)p_data[0] << 8) | p_data[1];
+            p_rec->address_upper <<= 16; // Shift into upper 16 bits of address space
         }
         else if (p_rec->type == IHX_REC_DATA) {
 
             // Don't process records with zero bytes of length
             if (p_rec->byte_count == 0) {
-                log_warning("Warning: IHX: Zero length record starting at %x\n", p_rec->address);
-                return false;
+                p_rec->status = IHX_PARSE_ZERO_LENGTH;
+                return;
             }
-
-            // Apply extended linear address (upper 16 bits of address space)
-            // Calculate end address
-            p_rec->address |= g_address_upper;
-            p_rec->address_end = p_rec->address + p_rec->byte_count - 1;
         }
 
-        // Read data segment and calculate checsum of data + headers
-        checksum_calc = p_rec->byte_count + (p_rec->address & 0xFF) + ((p_rec->address >> 8) & 0xFF) + p_rec->type;
-        for (c = 0;c < p_rec->byte_count;c++) {
-            sscanf(p_str, "%2x", &ctemp);
-            p_str += 2;
-            checksum_calc += ctemp;
-        }
+        // Checksum is the last byte of the record, everything before it is summed
+        p_rec->checksum = p_data[p_rec->byte_count];
+        byte_sum -= p_rec->checksum;
 
         // Final calculated checeksum is 2's complement of LSByte
-        checksum_calc = (((checksum_calc & 0xFF) ^ 0xFF) + 1) & 0xFF;
+        p_rec->checksum_calc = (((byte_sum & 0xFF) ^ 0xFF) + 1) & 0xFF;
+
+        if (p_rec->checksum != p_rec->checksum_calc)
+            p_rec->status = IHX_PARSE_BAD_CHECKSUM;
+        else
+            p_rec->status = IHX_PARSE_OK;
+}
 
-        // Read checksum from data
-        sscanf(p_str, "%2x", &p_rec->checksum);
-        p_str += 2;
 
-        if (p_rec->checksum != checksum_calc) {
-            log_warning("Warning: IHX: record checksum %x didn't match calculated checksum %x\n", p_rec->checksum, checksum_calc);
+// Log any warnings for a parsed record, returns false if the record failed validation
+//
+// last_address_end is the end address of the most recent data record
+static bool ihx_record_log_warnings(const ihx_record * p_rec, uint32_t last_address_end) {
+
+    switch (p_rec->status) {
+        case IHX_PARSE_BAD_START:
+            log_warning("Warning: IHX: Invalid start of line token for line: %.*s \n", p_rec->length, p_rec->p_line);
             return false;
-        }
 
-        // For records that start in banks above the unbanked region (0x000 - 0x3FFF)
-        // Warn if they cross the boundary between different banks
-        if ((p_rec->address >= 0x00004000U) &&
-            ((p_rec->address & 0xFFFFC000U) != (p_rec->address_end & 0xFFFFC000U))) {
-            log_warning("Warning: IHX: Write from one bank spans into the next. Bank overflow? %x -> %x (bank %d -> %d)\n",
-                   p_rec->address, p_rec->address_end, BANK_NUM(p_rec->address), BANK_NUM(p_rec->address_end));
-        }
+        case IHX_PARSE_TOO_SHORT:
+            log_warning("Warning: IHX: Invalid line, too few characters: %.*s. Is %d, needs at least %d \n", p_rec->length, p_rec->p_line, p_rec->length, IHX_REC_LEN_MIN);
+            return false;
+
+        case IHX_PARSE_NOT_HEX:
+            log_warning("Warning: IHX: Invalid line, non-hex characters present: %.*s\n", p_rec->length - 1, p_rec->p_line + 1);
+            return false;
+
+        case IHX_PARSE_BAD_LENGTH:
+            log_warning("Warning: IHX: byte count doesn't match length available in record! Record length = %d, Calc length = %d, bytecount = %d \n", p_rec->length, IHX_REC_LEN_MIN + (p_rec->byte_count * 2), p_rec->byte_count);
+            return false;
+
+        case IHX_PARSE_ZERO_LENGTH:
+            log_warning("Warning: IHX: Zero length record starting at %x\n", p_rec->address);
+            return false;
+
+        case IHX_PARSE_BAD_CHECKSUM:
+            log_warning("Warning: IHX: record checksum %x didn't match calculated checksum %x\n", p_rec->checksum, p_rec->checksum_calc);
+            return false;
+    }
+
+    // For records that start in banks above the unbanked region (0x000 - 0x3FFF)
+    // Warn if they cross the boundary between different banks
+    if ((p_rec->address >= 0x00004000U) &&
+        ((p_rec->address & 0xFFFFC000U) != (last_address_end & 0xFFFFC000U))) {
+        log_warning("Warning: IHX: Write from one bank spans into the next. Bank overflow? %x -> %x (bank %d -> %d)\n",
+               p_rec->address, last_address_end, BANK_NUM(p_rec->address), BANK_NUM(last_address_end));
+    }
 
     return true;
 }
 
+
+// Parse all records in a chunk of the file, may be called from a worker thread
+static void ihx_chunk_parse(uint32_t chunk_idx, void * p_ctx) {
+
+    ihx_parse_job * p_job   = (ihx_parse_job *)p_ctx;
+    ihx_chunk *     p_chunk = &(p_job->chunks[chunk_idx]);
+    uint32_t        file_pos = p_chunk->file_range.start;
+    const char *    p_line;
+    uint32_t        line_len;
+    ihx_record      ihx_rec;
+
+    list_init(&(p_chunk->records), sizeof(ihx_record));
+    list_reserve(&(p_chunk->records), (p_chunk->file_range.end - p_chunk->file_range.start) / IHX_REC_LINE_LEN_TYPICAL);
+    p_chunk->sets_address_upper = false;
+
+    // Walk through one line at a time, records are parsed in place
+    while ((file_pos < p_chunk->file_range.end) &&
+           file_buffer_next_line(p_job->p_file, &file_pos, &p_line, &line_len, MAX_STR_LEN - 1)) {
+
+        ihx_parse_and_validate_record(p_line, line_len, &ihx_rec);
+        list_additem(&(p_chunk->records), &ihx_rec);
+
+        // The extended linear address is applied even if the record checksum is bad
+        if (IHX_PARSE_HAS_ADDRESS(ihx_rec.status) && (ihx_rec.type == IHX_REC_EXTLIN)) {
+            p_chunk->sets_address_upper = true;
+            p_chunk->address_upper_last = ihx_rec.address_upper;
+        }
+    }
+}
+
+
+// Apply the active extended linear address to data records in a chunk, may be called from a worker thread
+static void ihx_chunk_resolve_addresses(uint32_t chunk_idx, void * p_ctx) {
+
+    ihx_parse_job * p_job   = (ihx_parse_job *)p_ctx;
+    ihx_chunk *     p_chunk = &(p_job->chunks[chunk_idx]);
+    ihx_record *    records = (ihx_record *)p_chunk->records.p_array;
+    uint32_t        address_upper = p_chunk->address_upper_start;
+
+    for (uint32_t c = 0; c < p_chunk->records.count; c++) {
+
+        if (!IHX_PARSE_HAS_ADDRESS(records[c].status)) continue;
+
+        if (records[c].type == IHX_REC_EXTLIN) {
+            address_upper = records[c].address_upper;
+        }
+        else if (records[c].type == IHX_REC_DATA) {
+            // Apply extended linear address (upper 16 bits of address space)
+            // Calculate end address
+            records[c].address |= address_upper;
+            records[c].address_end = records[c].address + records[c].byte_count - 1;
+        }
+    }
+}
+
+
 void area_convert_and_add(area_item area) {
 
     area_item t_area;
@@ -229,11 +382,13 @@ void area_convert_and_add(area_item area) {
 
 int ihx_file_process_areas(char * filename_in) {
 
-    char cols;
-    char strline_in[MAX_STR_LEN] = "";
-    FILE * ihx_file = fopen(filename_in, "r");
+    file_buffer ihx_file;
+    file_buffer_range * file_ranges;
+    ihx_parse_job job;
+    uint32_t    chunk_count;
+    uint32_t    last_address_end = 0;
     area_item area;
-    ihx_record ihx_rec;
+    ihx_record * p_rec;
 
     set_option_input_source(OPT_INPUT_SRC_IHX);
 
@@ -243,34 +398,64 @@ int ihx_file_process_areas(char * filename_in) {
     set_option_suppress_duplicates(false);
     set_option_all_areas_exclusive(true);
 
-    // Initialize global upper address modifier
-    g_address_upper = 0x0000;
-
     // Initialize area record
-    snprintf(area.name, sizeof(area.name), "ihx record");
+    area.name_id = str_intern("ihx record");
     area.exclusive = option_all_areas_exclusive; // Default is false
     area.start = ADDR_UNSET;
     area.end   = ADDR_UNSET;
 
-    if (ihx_file) {
+    // Map (or read) in the whole file
+    if (!file_buffer_load(&ihx_file, filename_in)) {
+        // Error message already logged when loading failed
+        return false;
+    }
+
+    // Records are parsed and validated in chunks (in parallel with -j)
+    job.p_file  = &ihx_file;
+    chunk_count = file_buffer_split_lines(&ihx_file, parallel_get_chunk_count(), IHX_CHUNK_SIZE_MIN, &file_ranges);
+    job.chunks  = (ihx_chunk *)calloc(chunk_count, sizeof(ihx_chunk));
+    if (!job.chunks) {
+        log_error("Error: Failed to allocate memory for IHX chunks!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t c = 0; c < chunk_count; c++)
+        job.chunks[c].file_range = file_ranges[c];
+    free(file_ranges);
+
+    parallel_for(chunk_count, ihx_chunk_parse, &job);
+
+    // Data records depend on the extended linear address set by earlier records,
+    // carry it forward to find the address active at the start of each chunk
+    for (uint32_t c = 0; c < chunk_count; c++) {
+        job.chunks[c].address_upper_start = (c == 0) ? 0x0000 : job.chunks[c - 1].address_upper_last;
+        if (!job.chunks[c].sets_address_upper)
+            job.chunks[c].address_upper_last = job.chunks[c].address_upper_start;
+    }
+    parallel_for(chunk_count, ihx_chunk_resolve_addresses, &job);
+
+    // Then process the records in file order
+    for (uint32_t c = 0; c < chunk_count; c++) {
+        for (uint32_t rec_idx = 0; rec_idx < job.chunks[c].records.count; rec_idx++) {
+
+            p_rec = &(((ihx_record *)job.chunks[c].records.p_array)[rec_idx]);
 
-        // Read one line at a time into \0 terminated string
-        while (fgets(strline_in, sizeof(strline_in), ihx_file) != NULL) {
+            if (IHX_PARSE_HAS_ADDRESS(p_rec->status) && (p_rec->type == IHX_REC_DATA))
+                last_address_end = p_rec->address_end;
 
-            // Parse record, skip if fails validation
-            if (!ihx_parse_and_validate_record(strline_in, &ihx_rec))
+            // Skip record if it failed validation
+            if (!ihx_record_log_warnings(p_rec, last_address_end))
                 continue;
 
             // Process the pending record and exit if last record (EOF)
             // Also ignore non-default data records (don't seem to occur for gbz80)
-            if (ihx_rec.type == IHX_REC_EOF) {
+            if (p_rec->type == IHX_REC_EOF) {
                 area_convert_and_add(area);
                 continue;
-            } else if (ihx_rec.type == IHX_REC_EXTLIN) {
-                // printf("Extended linear address changed to %08x %s\n\n\n", g_address_upper, strline_in);
+            } else if (p_rec->type == IHX_REC_EXTLIN) {
+                // printf("Extended linear address changed to %08x %.*s\n\n\n", p_rec->address_upper, p_rec->length, p_rec->p_line);
                 continue;
-            } else if (ihx_rec.type != IHX_REC_DATA) {
-                log_warning("Warning: IHX: dropped record %s of type %d\n", strline_in, ihx_rec.type);
+            } else if (p_rec->type != IHX_REC_DATA) {
+                log_warning("Warning: IHX: dropped record %.*s of type %d\n", p_rec->length, p_rec->p_line, p_rec->type);
                 continue;
             }
 
@@ -280,10 +465,10 @@ int ihx_file_process_areas(char * filename_in) {
             // Try to merge with (pending) previous record if it's address-adjacent,
             // except when the new record starts or ends on a bank boundary
             // (this reduces count from 1000's since most are only 32 bytes long)
-            if ((ihx_rec.address == area.end + 1) && IS_NOT_BANK_START(ihx_rec.address)) {
-                area.end = ihx_rec.address_end;  // append to previous area
-            } else if ((ihx_rec.address_end == area.start + 1) && IS_NOT_BANK_END(ihx_rec.address_end)) {
-                area.start = ihx_rec.address;    // pre-pend to previous area
+            if ((p_rec->address == area.end + 1) && IS_NOT_BANK_START(p_rec->address)) {
+                area.end = p_rec->address_end;  // append to previous area
+            } else if ((p_rec->address_end == area.start + 1) && IS_NOT_BANK_END(p_rec->address_end)) {
+                area.start = p_rec->address;    // pre-pend to previous area
             } else {
                 // New record was *not* adjacent to last,
                 // so process the last/pending record
@@ -291,20 +476,17 @@ int ihx_file_process_areas(char * filename_in) {
                     area_convert_and_add(area);
                 }
                 // Now queue current record as pending for next loop
-                area.start = ihx_rec.address;
-                area.end   = ihx_rec.address + ihx_rec.byte_count - 1;
+                area.start = p_rec->address;
+                area.end   = p_rec->address + p_rec->byte_count - 1;
             }
 
-        } // end: while still lines to process
+        } // end: while still records to process
 
-        fclose(ihx_file);
-
-    } // end: if valid file
-    else {
-        log_error("Error: Failed to open input file %s\n", filename_in);
-        return false;
+        list_cleanup(&(job.chunks[c].records));
     }
 
+    free(job.chunks);
+    file_buffer_release(&ihx_file);
+
     return true;
 }
-
@@ -9,29 +9,72 @@
 
 #include "logging.h"
 #include "list.h"
+#include "arena.h"
 
-#define LIST_GROW_SIZE 100 // 50 // grow array by N entries at a time
+#define LIST_SIZE_MIN 8 // Entries allocated for the first item, then doubled each time the list fills
 
-// Initialize the list and it's array
+// Initialize the list
 // typesize *must* match the type that will be used with the array
+//
+// Nothing gets allocated until the first item is added (or space is reserved)
 void list_init(list_type * p_list, size_t array_typesize) {
     p_list->typesize = array_typesize;
     p_list->count   = 0;
-    p_list->size    = LIST_GROW_SIZE;
-    p_list->p_array = (void *)malloc(p_list->size * p_list->typesize);
+    p_list->size    = 0;
+    p_list->p_array = NULL;
+    p_list->p_arena = NULL;
+}
 
-    if (!p_list->p_array) {
-        log_error("Error: Failed to allocate memory for list!\n");
-        exit(EXIT_FAILURE);
-    }
+
+// Initialize a list that allocates it's array from an arena
+//
+// The array is never freed individually, it goes away when the arena is released
+void list_init_arena(list_type * p_list, size_t array_typesize, arena_type * p_arena) {
+    list_init(p_list, array_typesize);
+    p_list->p_arena = p_arena;
 }
 
 
 // Free the array memory allocated for the list
+// (arena lists only drop the array, the arena owns it)
 void list_cleanup(list_type * p_list) {
-    if (p_list->p_array) {
+    if ((p_list->p_array) && (!p_list->p_arena))
         free (p_list->p_array);
-        p_list->p_array = NULL;
+    p_list->p_array = NULL;
+    p_list->size  = 0;
+    p_list->count = 0;
+}
+
+
+// Make sure the list has room for at least min_size items without reallocating
+// Useful when the number of items can be estimated ahead of time
+void list_reserve(list_type * p_list, uint32_t min_size) {
+
+    void * tmp_list;
+
+    if (min_size <= p_list->size)
+        return;
+
+    if (p_list->p_arena) {
+        p_list->p_array = arena_realloc(p_list->p_arena, p_list->p_array,
+                                        p_list->size * p_list->typesize, min_size * p_list->typesize);
+        p_list->size = min_size;
+        return;
+    }
+
+    // Save a copy in case reallocation fails
+    tmp_list = p_list->p_array;
+
+    p_list->size = min_size;
+    p_list->p_array = (void *)realloc(p_list->p_array, p_list->size * p_list->typesize);
+    // If realloc failed, free original buffer before quitting
+    if (!p_list->p_array) {
+        log_error("Error: Failed to reallocate memory for list!\n");
+        if (tmp_list) {
+            free(tmp_list);
+            tmp_list = NULL;
+        }
+        exit(EXIT_FAILURE);
     }
 }
 
@@ -39,33 +82,17 @@ void list_cleanup(list_type * p_list) {
 // Add a new item to the lists array, resize if needed
 // p_newitem *must* be the same type the list was initialized with
 // New item gets copied, so ok if it's a local var with limited lifetime
+//
+// The array doubles in size when full, so adding N items costs O(N) copying overall
 void list_additem(list_type * p_list, void * p_newitem) {
 
-    void * tmp_list;
-
-    p_list->count++;
-
     // Grow array if needed
-    if (p_list->count == p_list->size) {
-        // Save a copy in case reallocation fails
-        tmp_list = p_list->p_array;
-
-        p_list->size += LIST_GROW_SIZE;
-        p_list->p_array = (void *)realloc(p_list->p_array, p_list->size * p_list->typesize);
-        // If realloc failed, free original buffer before quitting
-        if (!p_list->p_array) {
-            log_error("Error: Failed to reallocate memory for list!\n");
-            if (tmp_list) {
-                free(tmp_list);
-                tmp_list = NULL;
-            }
-            exit(EXIT_FAILURE);
-        }
-    }
+    if (p_list->count == p_list->size)
+        list_reserve(p_list, (p_list->size < LIST_SIZE_MIN) ? LIST_SIZE_MIN : (p_list->size * 2));
 
     // Copy new entry
-    memcpy((uint_least8_t *)p_list->p_array + ((p_list->count - 1) * p_list->typesize),
+    memcpy((uint_least8_t *)p_list->p_array + (p_list->count * p_list->typesize),
            p_newitem,
            p_list->typesize);
+    p_list->count++;
 }
-
@@ -11,10 +11,13 @@ typedef struct list_type {
     uint32_t size;
     uint32_t count;
     size_t   typesize;
+    struct arena_type * p_arena; // Array is allocated from this when set, otherwise the heap
 } list_type;
 
 void list_init(list_type *, size_t);
+void list_init_arena(list_type *, size_t, struct arena_type *);
 void list_cleanup(list_type *);
 void list_additem(list_type *, void *);
+void list_reserve(list_type *, uint32_t);
 
 #endif // _LIST_H
\ No newline at end of file
@@ -12,6 +12,9 @@
 #include "common.h"
 #include "logging.h"
 #include "banks.h"
+#include "str_intern.h"
+#include "file_buffer.h"
+#include "parallel.h"
 #include "map_file.h"
 
 // Example data to parse from a .map file (excluding unwanted lines):
@@ -35,6 +38,46 @@ _HRAM10                00000000    00000001 =           1. bytes (ABS,CON)
 #define GBDK_AREA_SPLIT_WORDS 6
 #define BANK_NUM_UNSET 0xFFFFFFFF
 
+// Line types recognized by map_classify_line()
+#define MAP_LINE_OTHER        0 // Anything else, skipped without tokenizing
+#define MAP_LINE_RGBDS_BANK   1 // Contains " bank #"
+#define MAP_LINE_RGBDS_SECT   2 // Contains "  SECTION: " or "\tSECTION: "
+#define MAP_LINE_GBDK_AREA    3 // Contains "bytes", may be a GBDK area summary line
+
+// Files are split at line boundaries into chunks of at least this size for parallel parsing (-j)
+#define MAP_CHUNK_SIZE_MIN    0x10000U
+
+// Parsed line entries, stored in file order
+#define MAP_ENTRY_BANK        0 // RGBDS bank header, sets bank for following sections
+#define MAP_ENTRY_AREA        1 // Area ready to be added
+#define MAP_ENTRY_RGBDS_SECT  2 // RGBDS section, needs bank applied to address
+
+typedef struct map_entry {
+    uint8_t   type;
+    uint32_t  bank_num;   // For MAP_ENTRY_BANK
+    long      start_raw;  // For MAP_ENTRY_RGBDS_SECT, address before bank is applied
+    long      end_raw;
+    const char * p_name;  // Area name in the file data, interned once areas get added
+    uint32_t  name_len;
+    area_item area;
+} map_entry;
+
+typedef struct map_chunk {
+    file_buffer_range file_range;
+    list_type entries;
+    bool      sets_bank;  // Whether any RGBDS bank header is in the chunk
+    uint32_t  bank_last;  // Active RGBDS bank at end of chunk (if set in chunk)
+    uint32_t  bank_start; // Active RGBDS bank at start of chunk
+} map_chunk;
+
+typedef struct map_parse_job {
+    const file_buffer * p_file;
+    map_chunk *         chunks;
+} map_parse_job;
+
+// Check whether the text ending just before p_line[pos] matches str (of length len)
+#define MAP_ENDS_WITH(p_line, pos, str, len) (((pos) >= (len)) && (memcmp((p_line) + (pos) - (len), (str), (len)) == 0))
+
 
 
 static int str_split(char * str_check, char * p_words[], const char * split_criteria) {
@@ -55,102 +98,253 @@ static int str_split(char * str_check, char * p_words[], const char * split_crit
 }
 
 
-static void add_area_gbdk(char * p_words[]) {
+// Returns true if the area should be added
+static bool add_area_gbdk(char * p_words[], map_entry * p_entry) {
 
-    area_item area;
+    area_item * p_area = &(p_entry->area);
 
     if ((strtol(p_words[2], NULL, 16) > 0) &&  // Exclude empty areas
         !(strstr(p_words[0], "SFR")) &&        // Exclude SFR areas (not actually located at addresses in area listing)
         !(strstr(p_words[0], "HRAM"))          // Exclude HRAM area
         )
     {
-        snprintf(area.name, sizeof(area.name), "%s", p_words[0]); // [0] Area Name
-        area.start = strtol(p_words[1], NULL, 16);         // [1] Area Hex Address Start
-        area.end   = area.start + strtol(p_words[2], NULL, 16) - 1; // Start + [3] Hex Size - 1 = Area End
-        if (strstr(area.name,"HEADER"))
-            area.exclusive = false; // HEADER areas almost always overlap, ignore them
+        p_entry->p_name   = p_words[0];                      // [0] Area Name
+        p_entry->name_len = strlen(p_words[0]);
+        p_area->start = strtol(p_words[1], NULL, 16);         // [1] Area Hex Address Start
+        p_area->end   = p_area->start + strtol(p_words[2], NULL, 16) - 1; // Start + [3] Hex Size - 1 = Area End
+        if (strstr(p_words[0],"HEADER"))
+            p_area->exclusive = false; // HEADER areas almost always overlap, ignore them
         else
-            area.exclusive = option_all_areas_exclusive; // Default is false
-        banks_check(area);
+            p_area->exclusive = option_all_areas_exclusive; // Default is false
+        return true;
     }
+    return false;
 }
 
 
-static void add_area_rgbds(char * p_words[], int current_bank, const char * str_area_name) {
+// The bank number gets applied later with add_area_rgbds_bank()
+// since it comes from the most recent bank line, which may be in another chunk
+static void add_area_rgbds(char * p_words[], map_entry * p_entry, const char * str_area_name) {
+
+    p_entry->p_name   = str_area_name; // Area Name
+    p_entry->name_len = strlen(str_area_name);
+    p_entry->start_raw = strtol(p_words[1], NULL, 16);  // [1] Area Hex Address Start
+    p_entry->end_raw   = strtol(p_words[2], NULL, 16);  // [2] Area Hex Address End
+    p_entry->area.exclusive = option_all_areas_exclusive; // Default is false
+}
 
-    area_item area;
 
-    snprintf(area.name, sizeof(area.name), "%s", str_area_name);        // Area Name
-    area.start = strtol(p_words[1], NULL, 16) | (current_bank << 16);   // [1] Area Hex Address Start
-    area.end   = strtol(p_words[2], NULL, 16) | (current_bank << 16);   // [2] Area Hex Address End
-    area.exclusive = option_all_areas_exclusive; // Default is false
-    banks_check(area);
+static void add_area_rgbds_bank(map_entry * p_entry, int current_bank) {
+
+    p_entry->area.start = p_entry->start_raw | (current_bank << 16);
+    p_entry->area.end   = p_entry->end_raw   | (current_bank << 16);
+    p_entry->type       = MAP_ENTRY_AREA;
 }
 
 
-static int get_bank_num_rgbds(char * p_words[]) {
+// Area names are split out of a '\0' terminated copy of the line. Point them
+// at the same text in the file data instead, which stays loaded until areas get added.
+static void map_entry_name_to_file(map_entry * p_entry, const char * strline_in, const char * p_line) {
 
-    return strtol(p_words[2], NULL, 10);
+    if (p_entry->name_len > 0)
+        p_entry->p_name = p_line + (p_entry->p_name - strline_in);
 }
 
 
-int map_file_process_areas(char * filename_in) {
+static int get_bank_num_rgbds(char * p_words[]) {
 
-    uint32_t cur_bank_rgbds;
-    char * p_words[MAX_SPLIT_WORDS];
-    char strline_in[MAX_STR_LEN] = "";
-    FILE * map_file = fopen(filename_in, "r");
+    return strtol(p_words[2], NULL, 10);
+}
 
-    set_option_input_source(OPT_INPUT_SRC_MAP);
 
-    cur_bank_rgbds = BANK_NUM_UNSET;
+// Classify a line in a single pass by looking for the trailing character
+// of each marker string (" bank #", "SECTION: ", "bytes") and then checking
+// the text before it. Most lines in a GBDK map are symbol listings with none
+// of them and get rejected without any further work.
+//
+// Like strstr() the scan stops at the first \0 in the line.
+static int map_classify_line(const char * p_line, uint32_t line_len) {
+
+    bool is_section = false;
+    bool has_bytes  = false;
+
+    for (uint32_t c = 0; c < line_len; c++) {
+        switch (p_line[c]) {
+            case '\0':
+                c = line_len; // Stop at end of string
+                break;
+
+            case '#':
+                // RGBDS bank lines take precedence over everything else
+                if (MAP_ENDS_WITH(p_line, c, " bank ", 6))
+                    return MAP_LINE_RGBDS_BANK;
+                break;
+
+            case ':':
+                // "  SECTION: " or "\tSECTION: "
+                if ((c + 1 < line_len) && (p_line[c + 1] == ' ') && MAP_ENDS_WITH(p_line, c, "SECTION", 7) &&
+                    (MAP_ENDS_WITH(p_line, c - 7, "\t", 1) || MAP_ENDS_WITH(p_line, c - 7, "  ", 2)))
+                    is_section = true;
+                break;
+
+            case 's':
+                if (MAP_ENDS_WITH(p_line, c, "byte", 4))
+                    has_bytes = true;
+                break;
+        }
+    }
 
-    if (map_file) {
+    if (is_section) return MAP_LINE_RGBDS_SECT;
+    if (has_bytes)  return MAP_LINE_GBDK_AREA;
+    return MAP_LINE_OTHER;
+}
 
-        // Read one line at a time into \0 terminated string
-        while ( fgets(strline_in, sizeof(strline_in), map_file) != NULL) {
 
-            // RGBDS Bank Numbers: Bank lines precede Section lines, use them to set bank num
-            if (strstr(strline_in, " bank #")) {
-                if (str_split(strline_in,p_words," #:\r\n") == RGBDS_BANK_SPLIT_WORDS)
-                    cur_bank_rgbds = get_bank_num_rgbds(p_words);
+// Parse all lines in a chunk of the file, may be called from a worker thread
+static void map_chunk_parse(uint32_t chunk_idx, void * p_ctx) {
+
+    map_parse_job * p_job   = (map_parse_job *)p_ctx;
+    map_chunk *     p_chunk = &(p_job->chunks[chunk_idx]);
+    uint32_t        file_pos = p_chunk->file_range.start;
+    char *          p_words[MAX_SPLIT_WORDS];
+    char            strline_in[MAX_STR_LEN];
+    const char *    p_line;
+    uint32_t        line_len;
+    int             line_type;
+    map_entry       entry;
+
+    list_init(&(p_chunk->entries), sizeof(map_entry));
+    p_chunk->sets_bank = false;
+
+    // Walk the lines in place, only lines that might be used get copied and split
+    while ((file_pos < p_chunk->file_range.end) &&
+           file_buffer_next_line(p_job->p_file, &file_pos, &p_line, &line_len, MAX_STR_LEN - 1)) {
+
+        line_type = map_classify_line(p_line, line_len);
+        if (line_type == MAP_LINE_OTHER)
+            continue;
+
+        // Copy into a \0 terminated string for splitting
+        memcpy(strline_in, p_line, line_len);
+        strline_in[line_len] = '\0';
+
+        // RGBDS Bank Numbers: Bank lines precede Section lines, use them to set bank num
+        if (line_type == MAP_LINE_RGBDS_BANK) {
+            if (str_split(strline_in,p_words," #:\r\n") == RGBDS_BANK_SPLIT_WORDS) {
+                entry.type     = MAP_ENTRY_BANK;
+                entry.bank_num = get_bank_num_rgbds(p_words);
+                list_additem(&(p_chunk->entries), &entry);
+                p_chunk->sets_bank = true;
+                p_chunk->bank_last = entry.bank_num;
             }
-
-            // RGBDS Sections: Only parse lines that have Section (Area) summary info
-            else if (strstr(strline_in, "  SECTION: ") || strstr(strline_in, "\tSECTION: ")) {
-                if (cur_bank_rgbds != BANK_NUM_UNSET) {
-                    // Try to strip quote bracketed name out first
-                    int name_split_count = str_split(strline_in, p_words,"\"");
-                    if (name_split_count > 0) {
-                        // Save section name from array before splitting again (if not blank)
-                        const char * str_area_name = (name_split_count == RGBDS_SECT_NAME_SPLIT_WORDS) ? p_words[1] : "";
-                        // Then split up the remaining section info from first string in split array
-                        if (str_split(p_words[0], p_words," :$()[]\n\t\"") == RGBDS_SECT_INFO_SPLIT_WORDS)
-                            add_area_rgbds(p_words, cur_bank_rgbds, str_area_name);
-                    }
+        }
+
+        // RGBDS Sections: Only parse lines that have Section (Area) summary info
+        // (only used if a bank line was found before them, that gets checked once banks are resolved)
+        else if (line_type == MAP_LINE_RGBDS_SECT) {
+            // Try to strip quote bracketed name out first
+            int name_split_count = str_split(strline_in, p_words,"\"");
+            if (name_split_count > 0) {
+                // Save section name from array before splitting again (if not blank)
+                const char * str_area_name = (name_split_count == RGBDS_SECT_NAME_SPLIT_WORDS) ? p_words[1] : "";
+                // Then split up the remaining section info from first string in split array
+                if (str_split(p_words[0], p_words," :$()[]\n\t\"") == RGBDS_SECT_INFO_SPLIT_WORDS) {
+                    entry.type = MAP_ENTRY_RGBDS_SECT;
+                    add_area_rgbds(p_words, &entry, str_area_name);
+                    map_entry_name_to_file(&entry, strline_in, p_line);
+                    list_additem(&(p_chunk->entries), &entry);
                 }
             }
-
-            // Previous filtering now discontinued, areas with no leading "_" are allowed : GBDK Areas: Only parse lines that start with '_' character (Area summary lines)
-            // else if (strline_in[0] == '_') {
-            // }
-            else if (str_split(strline_in, p_words, " =.") == GBDK_AREA_SPLIT_WORDS) {
-                // Require a secondary match on a known column value ("bytes") to filter matches better
-                if (strstr(p_words[4], "bytes")) {
-                    add_area_gbdk(p_words);
+        }
+
+        // Previous filtering now discontinued, areas with no leading "_" are allowed : GBDK Areas: Only parse lines that start with '_' character (Area summary lines)
+        // GBDK Area lines always have "bytes" in them, so only those get split
+        else if (str_split(strline_in, p_words, " =.") == GBDK_AREA_SPLIT_WORDS) {
+            // Require a secondary match on a known column value ("bytes") to filter matches better
+            if (strstr(p_words[4], "bytes")) {
+                if (add_area_gbdk(p_words, &entry)) {
+                    map_entry_name_to_file(&entry, strline_in, p_line);
+                    entry.type = MAP_ENTRY_AREA;
+                    list_additem(&(p_chunk->entries), &entry);
                 }
             }
+        }
 
-        } // end: while still lines to process
+    } // end: while still lines to process
+}
+
+
+// Apply the active RGBDS bank to sections in a chunk, may be called from a worker thread
+static void map_chunk_resolve_banks(uint32_t chunk_idx, void * p_ctx) {
 
-        fclose(map_file);
+    map_parse_job * p_job    = (map_parse_job *)p_ctx;
+    map_chunk *     p_chunk  = &(p_job->chunks[chunk_idx]);
+    map_entry *     entries  = (map_entry *)p_chunk->entries.p_array;
+    uint32_t        cur_bank_rgbds = p_chunk->bank_start;
+
+    for (uint32_t c = 0; c < p_chunk->entries.count; c++) {
+        if (entries[c].type == MAP_ENTRY_BANK)
+            cur_bank_rgbds = entries[c].bank_num;
+        else if ((entries[c].type == MAP_ENTRY_RGBDS_SECT) && (cur_bank_rgbds != BANK_NUM_UNSET))
+            add_area_rgbds_bank(&entries[c], cur_bank_rgbds);
+        // Sections without a bank line before them are left unresolved and skipped
+    }
+}
 
-    } // end: if valid file
-    else {
-        log_error("Error: Failed to open input file %s\n", filename_in);
+
+int map_file_process_areas(char * filename_in) {
+
+    file_buffer         map_file;
+    file_buffer_range * file_ranges;
+    map_parse_job       job;
+    uint32_t            chunk_count;
+
+    set_option_input_source(OPT_INPUT_SRC_MAP);
+
+    // Map (or read) in the whole file
+    if (!file_buffer_load(&map_file, filename_in)) {
+        // Error message already logged when loading failed
         return false;
     }
 
+    // Lines are parsed in chunks (in parallel with -j)
+    job.p_file  = &map_file;
+    chunk_count = file_buffer_split_lines(&map_file, parallel_get_chunk_count(), MAP_CHUNK_SIZE_MIN, &file_ranges);
+    job.chunks  = (map_chunk *)calloc(chunk_count, sizeof(map_chunk));
+    if (!job.chunks) {
+        log_error("Error: Failed to allocate memory for map file chunks!\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint32_t c = 0; c < chunk_count; c++)
+        job.chunks[c].file_range = file_ranges[c];
+    free(file_ranges);
+
+    parallel_for(chunk_count, map_chunk_parse, &job);
+
+    // RGBDS sections use the bank from the most recent bank line,
+    // carry it forward to find the bank active at the start of each chunk
+    for (uint32_t c = 0; c < chunk_count; c++) {
+        job.chunks[c].bank_start = (c == 0) ? BANK_NUM_UNSET : job.chunks[c - 1].bank_last;
+        if (!job.chunks[c].sets_bank)
+            job.chunks[c].bank_last = job.chunks[c].bank_start;
+    }
+    parallel_for(chunk_count, map_chunk_resolve_banks, &job);
+
+    // Then add the areas in file order (names get interned here since it's not thread safe)
+    for (uint32_t c = 0; c < chunk_count; c++) {
+        map_entry * entries = (map_entry *)job.chunks[c].entries.p_array;
+
+        for (uint32_t e = 0; e < job.chunks[c].entries.count; e++) {
+            if (entries[e].type == MAP_ENTRY_AREA) {
+                entries[e].area.name_id = str_intern_len(entries[e].p_name, entries[e].name_len);
+                banks_check(entries[e].area);
+            }
+        }
+        list_cleanup(&(job.chunks[c].entries));
+    }
+
+    free(job.chunks);
+    file_buffer_release(&map_file);
+
    return true;
 }
-
@@ -13,15 +13,19 @@
 #include "logging.h"
 #include "list.h"
 #include "banks.h"
+#include "hash_index.h"
+#include "str_intern.h"
 #include "noi_file.h"
 
 
-list_type area_list;
+list_type  area_list;
+hash_index area_index; // Name lookup for area_list
 
 // Initialize the symbol list
 void noi_init(void) {
 
     list_init(&area_list, sizeof(area_item));
+    hash_index_init(&area_index);
 }
 
 
@@ -29,6 +33,7 @@ void noi_init(void) {
 void noi_cleanup(void) {
 
     list_cleanup(&area_list);
+    hash_index_cleanup(&area_index);
 }
 
 // Example data to parse from a .map file (excluding unwanted lines):
@@ -47,23 +52,31 @@ DEF s__BASE 0x6D4F
 
 
 
+// Hash index match function: compare an area name ID against an area in the list
+static bool arealist_name_matches(uint32_t area_idx, const void * p_key) {
+
+    return (((area_item *)area_list.p_array)[area_idx].name_id == *(const uint32_t *)p_key);
+}
+
+
 // Find a matching area, if none matches a new one is added and returned
+//
+// Note: Adding may reallocate the area list, so pointers
+//       into it should be retrieved *after* calling this
 static int arealist_get_id_by_name(char * area_name) {
 
-    area_item * areas = (area_item *)area_list.p_array;
-    area_item new_area;
-    int c;
+    area_item    new_area;
+    uint32_t     name_id = str_intern(area_name);
+    uint32_t     hash    = hash_index_hash_u32(name_id);
+    int32_t      area_id;
 
-    // Check for matching area name
-    for(c=0;c < area_list.count; c++) {
-        // Return matching area index if present
-        if (strncmp(area_name, areas[c].name, AREA_MAX_STR) == 0) {
-            return c;
-        }
-    }
+    area_id = hash_index_find(&area_index, hash, arealist_name_matches, &name_id);
+    // Return matching area index if present
+    if (area_id != HASH_INDEX_NOT_FOUND)
+        return area_id;
 
     // no match was found, add area
-    snprintf(new_area.name, sizeof(new_area.name), "%s", area_name);
+    new_area.name_id = name_id;
     new_area.start  = AREA_VAL_UNSET;
     new_area.end    = AREA_VAL_UNSET;
     new_area.length = AREA_VAL_UNSET;
@@ -71,8 +84,9 @@ static int arealist_get_id_by_name(char * area_name) {
         new_area.exclusive = false; // HEADER areas almost always overlap, ignore them
     else
         new_area.exclusive = option_all_areas_exclusive; // Default is false
-    
+
     list_additem(&area_list, &new_area);
+    hash_index_add(&area_index, hash, area_list.count - 1);
 
     return (area_list.count - 1);
 }
@@ -98,11 +112,11 @@ static void noi_arealist_add_all_to_banks() {
 
 static void noi_arealist_add(char * rec_type, char * name, char * value) {
 
-    area_item * areas = (area_item *)area_list.p_array;
-
     int area_id = arealist_get_id_by_name(name); // [2] Area Name1
     if (area_id != ERR_NO_AREAS_LEFT) {
 
+        area_item * areas = (area_item *)area_list.p_array;
+
         // Handle whether it's a start-of-address or a length record for the given area
         if (rec_type[0] == NOI_REC_START)
             areas[area_id].start = strtol(value, NULL, 16); // [2] Area Hex Address Start
@@ -0,0 +1,109 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "logging.h"
+#include "parallel.h"
+
+// The web build doesn't use threads unless built with pthread support
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    #define PARALLEL_THREADS_ENABLED
+    #include <pthread.h>
+#endif
+
+
+#ifdef PARALLEL_THREADS_ENABLED
+
+typedef struct parallel_job {
+    pthread_mutex_t  lock;
+    uint32_t         next_item;
+    uint32_t         item_count;
+    parallel_work_fn p_work_fn;
+    void *           p_ctx;
+} parallel_job;
+
+
+// Worker threads keep taking the next unclaimed item until there are none left
+static void * parallel_worker(void * p_arg) {
+
+    parallel_job * p_job = (parallel_job *)p_arg;
+    uint32_t item_idx;
+
+    while (true) {
+        pthread_mutex_lock(&p_job->lock);
+        item_idx = p_job->next_item;
+        if (item_idx < p_job->item_count)
+            p_job->next_item++;
+        pthread_mutex_unlock(&p_job->lock);
+
+        if (item_idx >= p_job->item_count) break;
+        p_job->p_work_fn(item_idx, p_job->p_ctx);
+    }
+    return NULL;
+}
+#endif
+
+// Split work into more pieces than threads to even out the load
+#define PARALLEL_CHUNKS_PER_THREAD 4
+
+
+// Number of pieces to split divisible work (such as an input file) into,
+// 1 when running single threaded
+uint32_t parallel_get_chunk_count(void) {
+
+    if (get_option_thread_count() <= 1) return 1;
+    else return get_option_thread_count() * PARALLEL_CHUNKS_PER_THREAD;
+}
+
+
+// Run p_work_fn for every item index in [0, item_count)
+//
+// Items are spread across up to the -j thread count. Completion order
+// is not defined, so results should be stored per item and combined by
+// the caller afterward. Falls back to running serially on the calling
+// thread when threads are disabled or unavailable.
+void parallel_for(uint32_t item_count, parallel_work_fn p_work_fn, void * p_ctx) {
+
+    uint32_t thread_count = min(get_option_thread_count(), item_count);
+
+    #ifdef PARALLEL_THREADS_ENABLED
+        if (thread_count > 1) {
+
+            pthread_t threads[OPT_THREAD_COUNT_MAX];
+            uint32_t  threads_started = 0;
+            parallel_job job;
+
+            job.next_item  = 0;
+            job.item_count = item_count;
+            job.p_work_fn  = p_work_fn;
+            job.p_ctx      = p_ctx;
+            pthread_mutex_init(&job.lock, NULL);
+
+            // The calling thread works too, so start one less
+            for (uint32_t c = 0; c < (thread_count - 1); c++) {
+                if (pthread_create(&threads[threads_started], NULL, parallel_worker, &job) == 0)
+                    threads_started++;
+                else
+                    log_verbose("Note: Failed to start worker thread, continuing with fewer\n");
+            }
+
+            parallel_worker(&job);
+
+            for (uint32_t c = 0; c < threads_started; c++)
+                pthread_join(threads[c], NULL);
+
+            pthread_mutex_destroy(&job.lock);
+            return;
+        }
+    #endif
+
+    for (uint32_t c = 0; c < item_count; c++)
+        p_work_fn(c, p_ctx);
+}
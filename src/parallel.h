@@ -0,0 +1,14 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#ifndef _PARALLEL_H
+#define _PARALLEL_H
+
+// Called once for each work item index, possibly from several threads at once
+typedef void (*parallel_work_fn)(uint32_t item_idx, void * p_ctx);
+
+uint32_t parallel_get_chunk_count(void);
+void parallel_for(uint32_t item_count, parallel_work_fn p_work_fn, void * p_ctx);
+
+#endif // _PARALLEL_H
@@ -13,13 +13,15 @@
 #include "logging.h"
 #include "list.h"
 #include "banks.h"
+#include "str_intern.h"
+#include "file_buffer.h"
+#include "rom_scan.h"
+#include "parallel.h"
 #include "rom_file.h"
 
 
 #define ADDR_UNSET 0xFFFFFFFF
 
-#define EMPTY_RUN_TOO_SHORT(length, threshold) ((length > 0) && (length < threshold))
-
 #define EMPTY_VALUE_MAX_COUNT               256
 #define EMPTY_DEFAULT_CONSECUTIVE_THRESHOLD 17
 #define EMPTY_0x00_CONSECUTIVE_THRESHOLD    128  // Larger threshold for 0x00 empty values due to possible sparse arrays
@@ -64,40 +66,6 @@ void romfile_init_defaults(void) {
 }
 
 
-// Read from a file into a buffer (will allocate needed memory)
-// Returns NULL if reading file didn't succeed
-uint8_t * file_read_into_buffer(char * filename, uint32_t *ret_size) {
-
-    long fsize;
-    FILE * file_in = fopen(filename, "rb");
-    uint8_t * filedata = NULL;
-
-    if (file_in) {
-        // Get file size
-        fseek(file_in, 0, SEEK_END);
-        fsize = ftell(file_in);
-        if (fsize != -1L) {
-            fseek(file_in, 0, SEEK_SET);
-
-            filedata = (uint8_t *)malloc(fsize);
-            if (filedata) {
-                if (fsize != fread(filedata, 1, fsize, file_in)) {
-                    log_warning("Warning: File read size didn't match expected for %s\n", filename);
-                    filedata = NULL;
-                }
-                // Read was successful, set return size
-                *ret_size = fsize;
-            } else log_error("Error: Failed to allocate memory to read file %s\n", filename);
-
-        } else log_error("Error: Failed to read size of file %s\n", filename);
-
-        fclose(file_in);
-    } else log_error("Error: Failed to open input file %s\n", filename);
-
-    return filedata;
-}
-
-
 // Calculate a range, adjust it's bank num and add try adding to banks if valid
 static void rom_add_range(area_item range, bool romsize_32K_or_less) {
 
@@ -130,123 +98,144 @@ static void rom_add_range(area_item range, bool romsize_32K_or_less) {
 
 
 
-int rom_file_process(char * filename_in) {
+// Used range found in a ROM bank (linear ROM addresses, inclusive)
+typedef struct rom_range {
+    uint32_t start;
+    uint32_t end;
+} rom_range;
 
-    char cols;
-    uint8_t * p_buf = NULL;
-    uint32_t buf_idx = 0;
-    uint32_t buf_length = 0;
-    uint32_t empty_run_length;
-    uint32_t empty_run_length_threshold;
-    uint8_t  empty_run_value;
-    uint32_t bank_bytes = 0;
-    area_item used_rom_range;
-    bool romsize_32K_or_less;
+// Shared state for scanning banks in parallel
+typedef struct rom_scan_job {
+    const uint8_t * p_buf;
+    uint32_t        buf_length;
+    list_type *     bank_ranges; // One list of rom_range per bank
+} rom_scan_job;
 
-    set_option_input_source(OPT_INPUT_SRC_ROM);
 
-    // Read in ROM image
-    p_buf = file_read_into_buffer(filename_in, &buf_length);
-    romsize_32K_or_less = (buf_length <= 0x8000);
-
-    used_rom_range.name[0] = '\0';  // Rom file ranges don't have names, set string to empty
-
-    if (p_buf) {
-
-        // Loop through all ROM bytes
-        while (buf_idx < buf_length) {
-
-            // This is looking for "Used" ranges broken up by non-"Empty" ranges
-            //
-            // Process each bank (0x4000 bytes in a row) separately
-            // and close out any ranges that might span between them
-
-            if (buf_length > BANK_SIZE) bank_bytes = BANK_SIZE;
-            else bank_bytes = buf_length;
-
-            // Reset range state values for each bank pass
-            used_rom_range.start = ADDR_UNSET;
-            empty_run_length = 0;
-
-            while (bank_bytes) {
-
-                // Split buffer up into potential runs of "Used" bytes with a
-                // threshold of N non-empty same value bytes in a row to split them up
-
-                uint8_t cur_byte_value = p_buf[buf_idx];
-
-                // Continue an existing run if the value matches the current runs value (0x00 or 0xFF)
-                if ((empty_run_length > 0) && (cur_byte_value == empty_run_value)) {
-                    empty_run_length++;
-
-                    // If the current "Empty" range is over the threshold it means
-                    // any existing "Used" data range needs to be closed out and submitted.
-                    //
-                    // Otherwise the "Empty" values may be part of data and can be ignored
-                    if ((empty_run_length >= empty_run_length_threshold) &&
-                        (used_rom_range.start != ADDR_UNSET)) {
-
-                        // Add range and back-calculate last "Used" range address using start of "empty" address
-                        used_rom_range.end = buf_idx - empty_run_length;
-                        rom_add_range(used_rom_range, romsize_32K_or_less);
-                        // Clear as ready for new range
-                        used_rom_range.start = ADDR_UNSET;
-                    }
-                }
-                else {
-                    // Close out pending failed (too short) "Empty" run
-                    if (EMPTY_RUN_TOO_SHORT(empty_run_length, empty_run_length_threshold)) {
-                        // If no range started, then convert it to a "Used" range since the bytes aren't actually empty
-                        if (used_rom_range.start == ADDR_UNSET) used_rom_range.start = buf_idx - empty_run_length;
-                    }
-
-                    // Start a potential "Empty" new run
-                    if (empty_values[cur_byte_value] == true) {
-                        empty_run_length = 1;
-                        empty_run_value = cur_byte_value;
-                        // "Empty" 0x00 byte values use a longer run length threshold due to possible sparse arrays
-                        empty_run_length_threshold = empty_consecutive_thresholds[cur_byte_value];
-                    }
-                    // Not "Empty", so reset "Empty" length
-                    else {
-                        empty_run_length = 0;
-                        // Start a potential "Used" (non-empty) data range if one isn't active.
-                        if (used_rom_range.start == ADDR_UNSET) used_rom_range.start = buf_idx;
-                    }
-
-                }
-
-                buf_idx++;
-                bank_bytes--;
-            } // end: while still _bank_ bytes to process
-
-            // End of Bank Cleanup
-
-            // Potentially Empty bytes at the end of a bank that don't meet threshold... might be empty?
-            //
-            // // Convert "Empty" run to "Used" if it didn't cross the "Empty" threshold
-            // if (EMPTY_RUN_TOO_SHORT(empty_run_length, empty_run_length_threshold)) {
-            //     if (used_rom_range.start == ADDR_UNSET) used_rom_range.start = buf_idx - empty_run_length;
-            // }
-
-            // Close pending "Used" run if needed (at last byte which is -1 of current)
-            if (used_rom_range.start != ADDR_UNSET) {
-                used_rom_range.end = (buf_idx - 1);
-                rom_add_range(used_rom_range, romsize_32K_or_less);
-            }
+// Find "Used" ranges in a single bank of ROM data [bank_start, bank_end)
+// and add them to p_ranges in address order.
+//
+// A "Used" range is anything between runs of "Empty" bytes (repeats of the
+// same empty value) that are at least as long as the threshold for that value.
+// Shorter "Empty" runs are treated as part of the data, except when one is the
+// only thing left at the end of the bank (it's dropped as possibly empty).
+//
+// Runs that long always contain a pair of repeated bytes, so the vector kernels
+// can skip ahead to the next pair instead of checking one byte at a time.
+static void rom_bank_find_used_ranges(const uint8_t * p_buf, uint32_t bank_start, uint32_t bank_end, list_type * p_ranges) {
+
+    rom_range used_range;
+    uint32_t  used_start = bank_start; // Start of pending "Used" range
+    uint32_t  run_start, run_end;
+    uint32_t  cur_idx = bank_start;    // Always at the start of a run of same value bytes
+    uint8_t   run_value;
+
+    while (cur_idx < bank_end) {
 
-        } // End main buffer loop
+        run_start = rom_scan_find_pair(p_buf, cur_idx, bank_end);
+        if (run_start == bank_end) break;
 
-        if (p_buf) {
-            free(p_buf);
-            p_buf = NULL;
+        run_value = p_buf[run_start];
+        run_end = rom_scan_find_mismatch(p_buf, run_start + 1, bank_end, run_value);
+
+        // Long enough "Empty" run, so close out any pending "Used" range before it
+        if ((empty_values[run_value] == true) &&
+            ((run_end - run_start) >= empty_consecutive_thresholds[run_value])) {
+
+            if (run_start > used_start) {
+                used_range.start = used_start;
+                used_range.end   = run_start - 1;
+                list_additem(p_ranges, &used_range);
+            }
+            used_start = run_end;
         }
+        cur_idx = run_end;
+    }
+
+    // Close pending "Used" range at the end of the bank if needed
+    if (used_start < bank_end) {
+
+        // Potentially Empty bytes at the end of a bank that don't meet threshold... might be empty?
+        // If that's all there is then don't count it as "Used"
+        run_value = p_buf[used_start];
+        if ((empty_values[run_value] == true) &&
+            (rom_scan_find_mismatch(p_buf, used_start, bank_end, run_value) == bank_end))
+            return;
 
-    } // end: if valid file
-    else {
+        used_range.start = used_start;
+        used_range.end   = bank_end - 1;
+        list_additem(p_ranges, &used_range);
+    }
+}
+
+
+// Scan one bank, may be called from a worker thread so results only go into that bank's list
+static void rom_scan_bank_worker(uint32_t bank_idx, void * p_ctx) {
+
+    rom_scan_job * p_job = (rom_scan_job *)p_ctx;
+    uint32_t bank_start = bank_idx * BANK_SIZE;
+    uint32_t bank_end   = min(bank_start + BANK_SIZE, p_job->buf_length);
+
+    list_init(&(p_job->bank_ranges[bank_idx]), sizeof(rom_range));
+    rom_bank_find_used_ranges(p_job->p_buf, bank_start, bank_end, &(p_job->bank_ranges[bank_idx]));
+}
+
+
+int rom_file_process(char * filename_in) {
+
+    file_buffer  rom_file;
+    rom_scan_job job;
+    uint32_t     bank_count;
+    area_item    used_rom_range;
+    bool         romsize_32K_or_less;
+
+    set_option_input_source(OPT_INPUT_SRC_ROM);
+
+    // Map (or read) in ROM image
+    if (!file_buffer_load(&rom_file, filename_in)) {
         log_error("Error: Failed to open input file %s\n", filename_in);
         return false;
     }
+    romsize_32K_or_less = (rom_file.size <= 0x8000);
+
+    // This is looking for "Used" ranges broken up by non-"Empty" ranges
+    //
+    // Each bank (0x4000 bytes in a row, last one may be partial) is processed
+    // separately and any ranges that might span between them are closed out,
+    // so banks can be scanned in parallel (-j) and then added in bank order.
+    // That way the result is the same regardless of the thread count.
+    rom_scan_init();
+
+    job.p_buf       = rom_file.p_data;
+    job.buf_length  = rom_file.size;
+    bank_count      = (rom_file.size + (BANK_SIZE - 1)) / BANK_SIZE;
+    job.bank_ranges = (list_type *)calloc(max(bank_count, 1), sizeof(list_type));
+
+    if (!job.bank_ranges) {
+        log_error("Error: Failed to allocate memory for ROM scan!\n");
+        file_buffer_release(&rom_file);
+        return false;
+    }
+
+    parallel_for(bank_count, rom_scan_bank_worker, &job);
+
+    used_rom_range.name_id = STR_INTERN_ID_EMPTY;  // Rom file ranges don't have names
+    used_rom_range.exclusive = false;  // Used ranges found by scanning never overlap each other
+
+    for (uint32_t bank_idx = 0; bank_idx < bank_count; bank_idx++) {
+
+        rom_range * ranges = (rom_range *)job.bank_ranges[bank_idx].p_array;
+
+        for (uint32_t c = 0; c < job.bank_ranges[bank_idx].count; c++) {
+            used_rom_range.start = ranges[c].start;
+            used_rom_range.end   = ranges[c].end;
+            rom_add_range(used_rom_range, romsize_32K_or_less);
+        }
+        list_cleanup(&(job.bank_ranges[bank_idx]));
+    }
+
+    free(job.bank_ranges);
+    file_buffer_release(&rom_file);
 
    return true;
 }
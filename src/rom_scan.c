@@ -0,0 +1,134 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rom_scan.h"
+
+// Vector versions are only built for x86 with GCC/Clang (needed for
+// per-function target attributes and runtime cpu feature checks).
+// The web build and other architectures use the scalar versions.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(__EMSCRIPTEN__)
+    #define ROM_SCAN_X86_SIMD
+    #include <immintrin.h>
+#endif
+
+
+// === Scalar versions ===
+
+static uint32_t find_pair_scalar(const uint8_t * p_buf, uint32_t start, uint32_t end) {
+
+    while ((start + 1) < end) {
+        if (p_buf[start] == p_buf[start + 1]) return start;
+        start++;
+    }
+    return end;
+}
+
+
+static uint32_t find_mismatch_scalar(const uint8_t * p_buf, uint32_t start, uint32_t end, uint8_t value) {
+
+    while (start < end) {
+        if (p_buf[start] != value) return start;
+        start++;
+    }
+    return end;
+}
+
+
+#ifdef ROM_SCAN_X86_SIMD
+
+// === SSE2 versions ===
+
+// Compare each byte against the byte following it, 16 at a time
+__attribute__((target("sse2")))
+static uint32_t find_pair_sse2(const uint8_t * p_buf, uint32_t start, uint32_t end) {
+
+    // Needs 16 + 1 bytes available for the offset load
+    while ((start + 16) < end) {
+        __m128i cur  = _mm_loadu_si128((const __m128i *)(p_buf + start));
+        __m128i next = _mm_loadu_si128((const __m128i *)(p_buf + start + 1));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(cur, next));
+        if (mask) return start + __builtin_ctz(mask);
+        start += 16;
+    }
+    return find_pair_scalar(p_buf, start, end);
+}
+
+
+__attribute__((target("sse2")))
+static uint32_t find_mismatch_sse2(const uint8_t * p_buf, uint32_t start, uint32_t end, uint8_t value) {
+
+    __m128i match = _mm_set1_epi8((char)value);
+
+    while ((start + 16) <= end) {
+        __m128i cur  = _mm_loadu_si128((const __m128i *)(p_buf + start));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(cur, match)) ^ 0xFFFFu;
+        if (mask) return start + __builtin_ctz(mask);
+        start += 16;
+    }
+    return find_mismatch_scalar(p_buf, start, end, value);
+}
+
+
+// === AVX2 versions ===
+
+__attribute__((target("avx2")))
+static uint32_t find_pair_avx2(const uint8_t * p_buf, uint32_t start, uint32_t end) {
+
+    // Needs 32 + 1 bytes available for the offset load
+    while ((start + 32) < end) {
+        __m256i cur  = _mm256_loadu_si256((const __m256i *)(p_buf + start));
+        __m256i next = _mm256_loadu_si256((const __m256i *)(p_buf + start + 1));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(cur, next));
+        if (mask) return start + __builtin_ctz(mask);
+        start += 32;
+    }
+    return find_pair_sse2(p_buf, start, end);
+}
+
+
+__attribute__((target("avx2")))
+static uint32_t find_mismatch_avx2(const uint8_t * p_buf, uint32_t start, uint32_t end, uint8_t value) {
+
+    __m256i match = _mm256_set1_epi8((char)value);
+
+    while ((start + 32) <= end) {
+        __m256i cur  = _mm256_loadu_si256((const __m256i *)(p_buf + start));
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(cur, match));
+        if (mask) return start + __builtin_ctz(mask);
+        start += 32;
+    }
+    return find_mismatch_sse2(p_buf, start, end, value);
+}
+
+#endif // ROM_SCAN_X86_SIMD
+
+
+uint32_t (*rom_scan_find_pair)(const uint8_t * p_buf, uint32_t start, uint32_t end) = find_pair_scalar;
+uint32_t (*rom_scan_find_mismatch)(const uint8_t * p_buf, uint32_t start, uint32_t end, uint8_t value) = find_mismatch_scalar;
+
+
+// Select the fastest scan versions the current CPU supports
+void rom_scan_init(void) {
+
+    rom_scan_find_pair     = find_pair_scalar;
+    rom_scan_find_mismatch = find_mismatch_scalar;
+
+    #ifdef ROM_SCAN_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            rom_scan_find_pair     = find_pair_avx2;
+            rom_scan_find_mismatch = find_mismatch_avx2;
+        }
+        else if (__builtin_cpu_supports("sse2")) {
+            rom_scan_find_pair     = find_pair_sse2;
+            rom_scan_find_mismatch = find_mismatch_sse2;
+        }
+    #endif
+}
@@ -0,0 +1,23 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#ifndef _ROM_SCAN_H
+#define _ROM_SCAN_H
+
+// Byte scanning kernels used by the binary ROM "empty" run detection.
+// Vectorized versions (SSE2/AVX2) are selected at runtime when available,
+// otherwise a plain scalar version is used.
+
+// Returns index of the first byte in [start, end) which is followed
+// by a byte with the same value (i.e. start of a run >= 2 bytes long).
+// Returns end if there isn't one.
+extern uint32_t (*rom_scan_find_pair)(const uint8_t * p_buf, uint32_t start, uint32_t end);
+
+// Returns index of the first byte in [start, end) which doesn't match value.
+// Returns end if all of them match.
+extern uint32_t (*rom_scan_find_mismatch)(const uint8_t * p_buf, uint32_t start, uint32_t end, uint8_t value);
+
+void rom_scan_init(void);
+
+#endif // _ROM_SCAN_H
@@ -62,6 +62,7 @@ static void display_help(int mode) {
            "-a  : Show Areas in each Bank. Optional sort by, address:\"-aA\" or size:\"-aS\" \n"
            "-g  : Show a small usage graph per bank (-gA for ascii style)\n"
            "-G  : Show a large usage graph per bank (-GA for ascii style)\n"
+           "      Optional bytes per character (default 16) -G:DECBYTES (ex: -G:64, -GA:64)\n"
            "-B  : Brief (summarized) output for banked regions. Auto scales max bank\n"
            "      shows [Region]_[Max Used Bank] / [auto-sized Max Bank Num]\n"
            "-F  : Force Max ROM and SRAM bank num for -B. (0 based) -F:ROM:SRAM (ex: -F:255:15)\n"
@@ -70,9 +71,12 @@ static void display_help(int mode) {
            "-e  : Manually specify an Area that should not overlap -e:NAME:HEXADDR:HEXLENGTH\n"
            "-b  : Set hex bytes treated as Empty in ROM files (.gb/etc) -b:HEXVAL[...] (default FF)\n"
            "-E  : All areas are exclusive (except HEADERs), warn for any overlaps\n"
+           "-dS : Legacy duplicate Area matching, names containing an existing Area's name count (slower)\n"
            "-q  : Quiet, no output except warnings and errors\n"
            "-Q  : Suppress output of warnings and errors\n"
            "-R  : Return error code for Area warnings and errors\n"
+           "-j  : Use multiple threads for processing .gb/etc, .ihx, .cdb and .map files\n"
+           "      -j for one per CPU, or -j:DECCOUNT (ex: -j:4)\n"
            "\n"
            "-sR : [Rainbow] Color output (-sRe for Row Ends, -sRd for Center Dimmed, -sRp %% based)\n"
            "-sP : Custom Color Palette. Colon separated entries are decimal VT100 color codes\n"
@@ -185,9 +189,19 @@ int handle_args(int argc, char * argv[]) {
             if (argv[i][2] == 'A') set_option_display_asciistyle(true);
         } else if (strstr(argv[i], "-G") == argv[i]) {
             banks_output_show_largegraph(true);
-            if (argv[i][2] == 'A') set_option_display_asciistyle(true);
+            char * p_arg = argv[i] + strlen("-G");
+            if (*p_arg == 'A') {
+                set_option_display_asciistyle(true);
+                p_arg++;
+            }
+            if (!set_option_largegraph_bytes_per_char(p_arg)) {
+                log_error("Malformed -G bytes per character: %s\n\n", argv[i]);
+                return false;
+            }
         } else if (strstr(argv[i], "-E") == argv[i]) {
             set_option_all_areas_exclusive(true);
+        } else if (strstr(argv[i], "-dS") == argv[i]) {
+            set_option_duplicates_substring(true);
 
         } else if (strstr(argv[i], "-B") == argv[i]) {
             set_option_summarized(true);
@@ -216,6 +230,12 @@ int handle_args(int argc, char * argv[]) {
         } else if (strstr(argv[i], "-R") == argv[i]) {
             set_option_error_on_warning(true);
 
+        } else if (strstr(argv[i], "-j") == argv[i]) {
+            if (!set_option_thread_count(argv[i] + strlen("-j"))) {
+                log_error("Malformed -j thread count: %s\n\n", argv[i]);
+                return false;
+            }
+
         } else if (strstr(argv[i], "-z:") == argv[i]) {
             set_option_area_hide_size( strtol(argv[i] + 3, NULL, 10));
 
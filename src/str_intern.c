@@ -0,0 +1,153 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "logging.h"
+#include "list.h"
+#include "hash_index.h"
+#include "str_intern.h"
+
+// String data gets packed into blocks of at least this size. Blocks are
+// never moved or resized, so pointers to interned strings remain valid.
+#define STR_INTERN_BLOCK_SIZE 0x10000U
+
+typedef struct str_intern_block {
+    struct str_intern_block * p_next;
+    uint32_t                  used;
+    uint32_t                  size;
+    // String data follows
+} str_intern_block;
+
+typedef struct str_intern_entry {
+    const char * p_str; // '\0' terminated
+    uint32_t     len;
+} str_intern_entry;
+
+// Lookup key for the hash index
+typedef struct str_intern_key {
+    const char * p_str; // Not '\0' terminated
+    uint32_t     len;
+} str_intern_key;
+
+static str_intern_block * p_blocks = NULL; // Most recent block first
+static list_type          str_entries;     // Indexed by string ID
+static hash_index         str_index;
+static bool               str_intern_ready = false;
+
+
+// Hash index match function: compare a key against an interned string
+static bool str_intern_matches(uint32_t str_id, const void * p_key) {
+
+    const str_intern_key *   p_str_key = (const str_intern_key *)p_key;
+    const str_intern_entry * p_entry   = &((const str_intern_entry *)str_entries.p_array)[str_id];
+
+    return ((p_entry->len == p_str_key->len) &&
+            (memcmp(p_entry->p_str, p_str_key->p_str, p_str_key->len) == 0));
+}
+
+
+// Copy a string into block storage, returns the '\0' terminated copy
+static const char * str_intern_store(const char * p_str, uint32_t len) {
+
+    char * p_dest;
+
+    if ((p_blocks == NULL) || ((p_blocks->size - p_blocks->used) < (len + 1))) {
+        uint32_t size = (len + 1 > STR_INTERN_BLOCK_SIZE) ? (len + 1) : STR_INTERN_BLOCK_SIZE;
+        str_intern_block * p_new_block = (str_intern_block *)malloc(sizeof(str_intern_block) + size);
+        if (!p_new_block) {
+            log_error("Error: Failed to allocate memory for strings!\n");
+            exit(EXIT_FAILURE);
+        }
+        p_new_block->p_next = p_blocks;
+        p_new_block->used   = 0;
+        p_new_block->size   = size;
+        p_blocks = p_new_block;
+    }
+
+    p_dest = (char *)(p_blocks + 1) + p_blocks->used;
+    memcpy(p_dest, p_str, len);
+    p_dest[len] = '\0';
+    p_blocks->used += len + 1;
+
+    return p_dest;
+}
+
+
+void str_intern_init(void) {
+
+    if (str_intern_ready)
+        str_intern_cleanup();
+
+    p_blocks = NULL;
+    list_init(&str_entries, sizeof(str_intern_entry));
+    hash_index_init(&str_index);
+    str_intern_ready = true;
+
+    // Always ID 0
+    str_intern_len("", 0);
+}
+
+
+// Free all interned strings, any IDs and pointers to them are invalid afterward
+void str_intern_cleanup(void) {
+
+    while (p_blocks) {
+        str_intern_block * p_next = p_blocks->p_next;
+        free(p_blocks);
+        p_blocks = p_next;
+    }
+    list_cleanup(&str_entries);
+    hash_index_cleanup(&str_index);
+    str_intern_ready = false;
+}
+
+
+// Returns the ID for a string with known length (doesn't need to be '\0' terminated),
+// adding it if not already present
+uint32_t str_intern_len(const char * p_str, uint32_t len) {
+
+    str_intern_key   key;
+    str_intern_entry new_entry;
+    uint32_t         hash;
+    int32_t          str_id;
+
+    key.p_str = p_str;
+    key.len   = len;
+    hash = hash_index_hash_str(p_str, len);
+
+    str_id = hash_index_find(&str_index, hash, str_intern_matches, &key);
+    if (str_id != HASH_INDEX_NOT_FOUND)
+        return (uint32_t)str_id;
+
+    new_entry.p_str = str_intern_store(p_str, len);
+    new_entry.len   = len;
+    list_additem(&str_entries, &new_entry);
+    hash_index_add(&str_index, hash, str_entries.count - 1);
+
+    return str_entries.count - 1;
+}
+
+
+// Returns the ID for a '\0' terminated string, adding it if not already present
+uint32_t str_intern(const char * p_str) {
+
+    return str_intern_len(p_str, (uint32_t)strlen(p_str));
+}
+
+
+const char * str_intern_get(uint32_t str_id) {
+
+    return ((const str_intern_entry *)str_entries.p_array)[str_id].p_str;
+}
+
+
+uint32_t str_intern_get_len(uint32_t str_id) {
+
+    return ((const str_intern_entry *)str_entries.p_array)[str_id].len;
+}
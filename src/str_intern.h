@@ -0,0 +1,24 @@
+// This is free and unencumbered software released into the public domain.
+// For more information, please refer to <https://unlicense.org>
+// bbbbbr 2020
+
+#ifndef _STR_INTERN_H
+#define _STR_INTERN_H
+
+// Interned strings: each distinct string is stored once and referred to
+// by a 32 bit ID, so equal IDs always mean equal strings.
+//
+// Strings live until str_intern_cleanup(), pointers returned by
+// str_intern_get() stay valid until then. Not thread safe, intern
+// from the main thread only.
+
+#define STR_INTERN_ID_EMPTY 0 // "" is always present with this ID
+
+void         str_intern_init(void);
+void         str_intern_cleanup(void);
+uint32_t     str_intern(const char * p_str);
+uint32_t     str_intern_len(const char * p_str, uint32_t len);
+const char * str_intern_get(uint32_t str_id);
+uint32_t     str_intern_get_len(uint32_t str_id);
+
+#endif // _STR_INTERN_H